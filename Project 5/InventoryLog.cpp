@@ -0,0 +1,403 @@
+/**
+ * @brief This file contains the implementation of the InventoryLog class, which appends binary stock events to a log file with group commit in a virtual bistro simulation.
+*/
+
+#include "InventoryLog.hpp"
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+
+constexpr std::chrono::milliseconds InventoryLog::FLUSH_INTERVAL;
+
+/**
+* Appends a 4-byte integer.
+* @param value The integer to encode.
+*/
+void InventoryLog::Writer::putInt(int value) {
+    bytes.insert(bytes.end(), (const char*)&value, (const char*)&value + sizeof(value));
+}
+
+/**
+* Appends an 8-byte integer.
+* @param value The integer to encode.
+*/
+void InventoryLog::Writer::putLong(long long value) {
+    bytes.insert(bytes.end(), (const char*)&value, (const char*)&value + sizeof(value));
+}
+
+/**
+* Appends a double.
+* @param value The double to encode.
+*/
+void InventoryLog::Writer::putDouble(double value) {
+    bytes.insert(bytes.end(), (const char*)&value, (const char*)&value + sizeof(value));
+}
+
+/**
+* Appends a string as its length followed by its characters.
+* @param value The string to encode.
+*/
+void InventoryLog::Writer::putString(const std::string& value) {
+    putInt(value.size());
+    bytes.insert(bytes.end(), value.begin(), value.end());
+}
+
+/**
+* Appends every field of an ingredient.
+* @param ingredient The ingredient to encode.
+*/
+void InventoryLog::Writer::putIngredient(const Ingredient& ingredient) {
+    putString(ingredient.name);
+    putInt(ingredient.quantity);
+    putInt(ingredient.required_quantity);
+    putDouble(ingredient.price);
+}
+
+/**
+* Appends a dish's name, cuisine, prep time, price and ingredients.
+* @param dish The dish to encode.
+*/
+void InventoryLog::Writer::putDish(const Dish& dish) {
+    std::vector<Ingredient> ingre = dish.getIngredients();
+
+    putString(dish.getName());
+    putString(dish.getCuisineType());
+    putInt(dish.getPrepTime());
+    putDouble(dish.getPrice());
+    putInt(ingre.size());
+    for (size_t i = 0; i < ingre.size(); i++)
+        putIngredient(ingre[i]);
+}
+
+/**
+* Appends a station's name, dishes and in-stock ingredients.
+* @param name The station's name.
+* @param dishes The station's dishes.
+* @param stock The station's in-stock ingredients.
+*/
+void InventoryLog::Writer::putStation(const std::string& name, const std::vector<const Dish*>& dishes, const std::vector<Ingredient>& stock) {
+    putString(name);
+    putInt(dishes.size());
+    for (size_t i = 0; i < dishes.size(); i++)
+        putDish(*dishes[i]);
+    putInt(stock.size());
+    for (size_t i = 0; i < stock.size(); i++)
+        putIngredient(stock[i]);
+}
+
+/**
+* Parameterized Constructor
+* @param data The encoded bytes.
+* @param size The number of bytes.
+*/
+InventoryLog::Reader::Reader(const char* data, int size) : data_(data), size_(size), pos_(0) {
+}
+
+/**
+* Copies the next bytes out of the buffer.
+* @param out Receives the bytes.
+* @param count The number of bytes.
+* @return: False if fewer than count bytes are left.
+*/
+bool InventoryLog::Reader::getBytes(void* out, int count) {
+    if (count < 0 || size_ - pos_ < count)
+        return false;
+
+    std::memcpy(out, data_ + pos_, count);
+    pos_ += count;
+    return true;
+}
+
+/**
+* Reads a 4-byte integer.
+* @param value Receives the integer.
+* @return: False if the buffer ran out.
+*/
+bool InventoryLog::Reader::getInt(int& value) {
+    return getBytes(&value, sizeof(value));
+}
+
+/**
+* Reads an 8-byte integer.
+* @param value Receives the integer.
+* @return: False if the buffer ran out.
+*/
+bool InventoryLog::Reader::getLong(long long& value) {
+    return getBytes(&value, sizeof(value));
+}
+
+/**
+* Reads a double.
+* @param value Receives the double.
+* @return: False if the buffer ran out.
+*/
+bool InventoryLog::Reader::getDouble(double& value) {
+    return getBytes(&value, sizeof(value));
+}
+
+/**
+* Reads a length-prefixed string.
+* @param value Receives the string.
+* @return: False if the buffer ran out.
+*/
+bool InventoryLog::Reader::getString(std::string& value) {
+    int length;
+
+    if (!getInt(length) || length < 0 || size_ - pos_ < length)
+        return false;
+
+    value.assign(data_ + pos_, length);
+    pos_ += length;
+    return true;
+}
+
+/**
+* Reads every field of an ingredient.
+* @param ingredient Receives the ingredient.
+* @return: False if the buffer ran out.
+*/
+bool InventoryLog::Reader::getIngredient(Ingredient& ingredient) {
+    return getString(ingredient.name) && getInt(ingredient.quantity) && getInt(ingredient.required_quantity) && getDouble(ingredient.price);
+}
+
+/**
+* Decodes a dish written by Writer::putDish.
+* @return: A new Dish owned by the caller, or nullptr if the buffer ran
+out.
+*/
+Dish* InventoryLog::Reader::getDish() {
+    static const char* cuisines[] = {"ITALIAN", "MEXICAN", "CHINESE", "INDIAN", "AMERICAN", "FRENCH", "OTHER"};
+    std::string name, cuisine;
+    int prep_time, count;
+    double price;
+
+    if (!getString(name) || !getString(cuisine) || !getInt(prep_time) || !getDouble(price) || !getInt(count) || count < 0)
+        return nullptr;
+
+    std::vector<Ingredient> ingre(count);
+    for (int i = 0; i < count; i++) {
+        if (!getIngredient(ingre[i]))
+            return nullptr;
+    }
+
+    //Mapping the cuisine back to its enum; unknown names become OTHER
+    Dish::CuisineType cuisine_type = Dish::OTHER;
+    for (int i = 0; i <= Dish::OTHER; i++) {
+        if (cuisine == cuisines[i])
+            cuisine_type = (Dish::CuisineType)i;
+    }
+
+    return new Dish(name, ingre, prep_time, price, cuisine_type);
+}
+
+/**
+* Parameterized Constructor
+* @param path The log file; events are appended after its current
+contents.
+* @post: Opens the file and starts the flusher thread. isOpen is false if
+the file could not be opened, and appends are then dropped.
+*/
+InventoryLog::InventoryLog(const std::string& path)
+    : file_(std::fopen(path.c_str(), "ab")), file_size_(0), stopping_(false), flusher_(&InventoryLog::run, this) {
+    if (file_ != nullptr) {
+        std::fseek(file_, 0, SEEK_END);
+        std::lock_guard<std::mutex> lock(write_mutex_);
+        file_size_ = std::ftell(file_);
+    }
+}
+
+/**
+* Destructor
+* @post: Writes every appended event and joins the flusher thread.
+*/
+InventoryLog::~InventoryLog() {
+    {
+        std::lock_guard<std::mutex> lock(pending_mutex_);
+        stopping_ = true;
+    }
+    pending_ready_.notify_one();
+    flusher_.join();
+
+    writePending();
+    if (file_ != nullptr)
+        std::fclose(file_);
+}
+
+/**
+* Checks whether the log file is open.
+* @return: True if events reach the file; false otherwise.
+*/
+bool InventoryLog::isOpen() const {
+    return file_ != nullptr;
+}
+
+/**
+* Appends an event. Safe to call from any thread; it only copies the
+event into the pending buffer.
+* @param type The kind of event.
+* @param body The encoded event.
+*/
+void InventoryLog::append(EventType type, const Writer& body) {
+    if (file_ == nullptr)
+        return;
+
+    int length = body.bytes.size();
+    bool wake;
+    {
+        std::lock_guard<std::mutex> lock(pending_mutex_);
+        pending_.push_back((char)type);
+        pending_.insert(pending_.end(), (const char*)&length, (const char*)&length + sizeof(length));
+        pending_.insert(pending_.end(), body.bytes.begin(), body.bytes.end());
+        wake = pending_.size() >= GROUP_COMMIT_BYTES;
+    }
+
+    if (wake)
+        pending_ready_.notify_one();
+}
+
+/**
+* Writes every event appended so far.
+* @return: The size of the log file afterwards.
+*/
+long long InventoryLog::flush() {
+    writePending();
+
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    return file_size_;
+}
+
+/**
+* Moves the pending buffer to the file.
+* @post: Every event appended before the call is written and synced to
+the disk, one fdatasync per group.
+*/
+void InventoryLog::writePending() {
+    std::lock_guard<std::mutex> write_lock(write_mutex_);
+    std::vector<char> group;
+
+    //Taking the whole group so appenders only wait for a swap
+    {
+        std::lock_guard<std::mutex> lock(pending_mutex_);
+        group.swap(pending_);
+    }
+
+    if (group.empty() || file_ == nullptr)
+        return;
+
+    file_size_ += std::fwrite(group.data(), 1, group.size(), file_);
+    std::fflush(file_);
+
+    //The whole group shares one sync, which is what makes the commit a group commit
+    fdatasync(fileno(file_));
+}
+
+/**
+* The flusher thread's loop.
+* @post: Writes the pending buffer every FLUSH_INTERVAL, or sooner if it
+reaches GROUP_COMMIT_BYTES, until stopping_ is set.
+*/
+void InventoryLog::run() {
+    std::unique_lock<std::mutex> lock(pending_mutex_);
+
+    while (!stopping_) {
+        pending_ready_.wait_for(lock, FLUSH_INTERVAL, [this] { return stopping_ || pending_.size() >= GROUP_COMMIT_BYTES; });
+
+        lock.unlock();
+        writePending();
+        lock.lock();
+    }
+}
+
+/**
+* Reads the events of a log file.
+* @param path The log file.
+* @param offset The offset of the first event to read.
+* @param apply Called with each complete event, in order. A torn record
+at the end of the file is ignored.
+* @return: False if the file could not be opened; true otherwise.
+*/
+bool InventoryLog::readEvents(const std::string& path, long long offset, const std::function<void(EventType, Reader&)>& apply) {
+    std::vector<char> bytes;
+
+    if (!readFile(path, bytes))
+        return false;
+
+    long long pos = offset;
+    while (pos + 1 + (long long)sizeof(int) <= (long long)bytes.size()) {
+        EventType type = (EventType)bytes[pos];
+        int length;
+        std::memcpy(&length, bytes.data() + pos + 1, sizeof(length));
+
+        //Stopping at a record the crash cut short
+        if (length < 0 || pos + 1 + (long long)sizeof(int) + length > (long long)bytes.size())
+            break;
+
+        Reader body(bytes.data() + pos + 1 + sizeof(int), length);
+        apply(type, body);
+        pos += 1 + sizeof(int) + length;
+    }
+
+    return true;
+}
+
+/**
+* Replaces a file's contents by writing a temporary file and renaming it
+over the target. The temporary file is synced before the rename and its
+directory after.
+* @param path The file to write.
+* @param bytes The new contents.
+* @return: True if the file was replaced; false otherwise.
+*/
+bool InventoryLog::writeFileAtomically(const std::string& path, const std::vector<char>& bytes) {
+    std::string temp = path + ".tmp";
+    std::FILE* file = std::fopen(temp.c_str(), "wb");
+
+    if (file == nullptr)
+        return false;
+
+    bool written = std::fwrite(bytes.data(), 1, bytes.size(), file) == bytes.size();
+    written = std::fflush(file) == 0 && written;
+
+    //The contents must be on the disk before the rename can make them the file's
+    written = fsync(fileno(file)) == 0 && written;
+    written = std::fclose(file) == 0 && written;
+
+    if (!written || std::rename(temp.c_str(), path.c_str()) != 0) {
+        std::remove(temp.c_str());
+        return false;
+    }
+
+    //Syncing the directory so the rename itself survives a crash
+    std::string::size_type slash = path.rfind('/');
+    std::string directory = slash == std::string::npos ? "." : (slash == 0 ? "/" : path.substr(0, slash));
+    int dir_fd = open(directory.c_str(), O_RDONLY | O_DIRECTORY);
+
+    if (dir_fd == -1)
+        return false;
+
+    bool synced = fsync(dir_fd) == 0;
+    close(dir_fd);
+    return synced;
+}
+
+/**
+* Reads a whole file.
+* @param path The file to read.
+* @param bytes Receives the contents.
+* @return: True if the file was read; false otherwise.
+*/
+bool InventoryLog::readFile(const std::string& path, std::vector<char>& bytes) {
+    std::FILE* file = std::fopen(path.c_str(), "rb");
+
+    if (file == nullptr)
+        return false;
+
+    std::fseek(file, 0, SEEK_END);
+    long size = std::ftell(file);
+    std::fseek(file, 0, SEEK_SET);
+
+    bytes.resize(size > 0 ? size : 0);
+    bool read = std::fread(bytes.data(), 1, bytes.size(), file) == bytes.size();
+    std::fclose(file);
+    return read;
+}
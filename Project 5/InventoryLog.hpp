@@ -0,0 +1,181 @@
+/**
+ * @brief This file contains the declaration of the InventoryLog class, which appends binary stock events to a log file with group commit in a virtual bistro simulation.
+*/
+
+#ifndef INVENTORYLOG_HPP
+#define INVENTORYLOG_HPP
+
+#include "Dish.hpp"
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <chrono>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <thread>
+
+class InventoryLog {
+    public:
+        /**
+        * Kinds of events. Each record is the type byte, the body length as a
+        4-byte integer, then the body.
+        */
+        enum EventType : unsigned char {
+            ADD_STATION = 1, //station contents (see Writer::putStation)
+            REMOVE_STATION = 2, //station name
+            MERGE_STATIONS = 3, //surviving station name, merged station name
+            ASSIGN_DISH = 4, //station name, dish
+            REPLENISH = 5, //station name, ingredient
+            PREPARE = 6, //station name, dish name, servings
+            RENAME_STATION = 7 //old station name, new station name
+        };
+
+        /**
+        * Encodes values into a byte buffer. Integers and doubles are stored
+        in the machine's byte order; strings are length-prefixed.
+        */
+        class Writer {
+            public:
+                void putInt(int value);
+                void putLong(long long value);
+                void putDouble(double value);
+                void putString(const std::string& value);
+                void putIngredient(const Ingredient& ingredient);
+                void putDish(const Dish& dish);
+
+                /**
+                * Encodes a station's name, dishes and in-stock ingredients.
+                */
+                void putStation(const std::string& name, const std::vector<const Dish*>& dishes, const std::vector<Ingredient>& stock);
+
+                std::vector<char> bytes; //everything encoded so far
+        };
+
+        /**
+        * Decodes values written by Writer. Every get returns false once the
+        buffer runs out, leaving the value untouched.
+        */
+        class Reader {
+            public:
+                Reader(const char* data, int size);
+                bool getInt(int& value);
+                bool getLong(long long& value);
+                bool getDouble(double& value);
+                bool getString(std::string& value);
+                bool getIngredient(Ingredient& ingredient);
+
+                /**
+                * @return: A new Dish owned by the caller, or nullptr if the
+                buffer ran out.
+                */
+                Dish* getDish();
+
+            private:
+                const char* data_;
+                int size_;
+                int pos_;
+
+                bool getBytes(void* out, int count);
+        };
+
+        /**
+        * Parameterized Constructor
+        * @param path The log file; events are appended after its current
+        contents.
+        * @post: Opens the file and starts the flusher thread. isOpen is false
+        if the file could not be opened, and appends are then dropped.
+        */
+        InventoryLog(const std::string& path);
+
+        /**
+        * Destructor
+        * @post: Writes every appended event and joins the flusher thread.
+        */
+        ~InventoryLog();
+
+        InventoryLog(const InventoryLog&) = delete;
+        InventoryLog& operator=(const InventoryLog&) = delete;
+
+        /**
+        * Checks whether the log file is open.
+        * @return: True if events reach the file; false otherwise.
+        */
+        bool isOpen() const;
+
+        /**
+        * Appends an event. Safe to call from any thread; it only copies the
+        event into the pending buffer, which the flusher thread writes out in
+        groups.
+        * @param type The kind of event.
+        * @param body The encoded event.
+        */
+        void append(EventType type, const Writer& body);
+
+        /**
+        * Writes every event appended so far and syncs it to the disk.
+        * @return: The size of the log file afterwards, i.e. the offset at
+        which the next event will start.
+        */
+        long long flush();
+
+        /**
+        * Reads the events of a log file.
+        * @param path The log file.
+        * @param offset The offset of the first event to read.
+        * @param apply Called with each complete event, in order. A torn
+        record at the end of the file (from a crash mid-write) is ignored.
+        * @return: False if the file could not be opened; true otherwise.
+        */
+        static bool readEvents(const std::string& path, long long offset, const std::function<void(EventType, Reader&)>& apply);
+
+        /**
+        * Replaces a file's contents by writing a temporary file and renaming
+        it over the target, so readers never see a partial file. The
+        temporary file is synced before the rename and its directory after,
+        so a crash leaves either the old or the new contents on the disk.
+        * @param path The file to write.
+        * @param bytes The new contents.
+        * @return: True if the file was replaced; false otherwise.
+        */
+        static bool writeFileAtomically(const std::string& path, const std::vector<char>& bytes);
+
+        /**
+        * Reads a whole file.
+        * @param path The file to read.
+        * @param bytes Receives the contents.
+        * @return: True if the file was read; false otherwise.
+        */
+        static bool readFile(const std::string& path, std::vector<char>& bytes);
+
+    private:
+        //Pending bytes that wake the flusher before its interval is up
+        static const int GROUP_COMMIT_BYTES = 64 * 1024;
+        //How long an event can wait in the pending buffer
+        static constexpr std::chrono::milliseconds FLUSH_INTERVAL{5};
+
+        std::FILE* file_; //the log file, or nullptr
+        long long file_size_; //bytes written to file_; guarded by write_mutex_
+        std::vector<char> pending_; //events appended but not written yet
+        std::mutex pending_mutex_; //guards pending_ and stopping_
+        std::mutex write_mutex_; //serializes writers so groups reach the file in append order
+        std::condition_variable pending_ready_; //signalled when pending_ is large or the log stops
+        bool stopping_; //set by the destructor
+        std::thread flusher_; //started last, after every other member is ready
+
+        /**
+        * Moves the pending buffer to the file.
+        * @post: Every event appended before the call is written and synced
+        to the disk, one fdatasync per group.
+        */
+        void writePending();
+
+        /**
+        * The flusher thread's loop.
+        * @post: Writes the pending buffer every FLUSH_INTERVAL, or sooner if
+        it reaches GROUP_COMMIT_BYTES, until stopping_ is set.
+        */
+        void run();
+};
+
+#endif // INVENTORYLOG_HPP
@@ -5,6 +5,8 @@
 */
 
 #include "KitchenStation.hpp"
+#include <algorithm>
+#include <climits>
 
 /**
 * Default Constructor
@@ -13,7 +15,6 @@
 KitchenStation::KitchenStation() {
     station_name_ = "UNKNOWN";
     dishes_ = {};
-    ingredients_stock_ = {};
 }
 
 /**
@@ -24,19 +25,16 @@ KitchenStation::KitchenStation() {
 KitchenStation::KitchenStation(const std::string& station_name) {
     station_name_ = station_name;
     dishes_ = {};
-    ingredients_stock_ = {};
 }
 
 /**
 * Destructor
-* @post: Deallocates all dynamically allocated dishes in the
-station.
+* @post: Releases the station's references to its recipes; a recipe no
+other station refers to is deallocated.
 */
 KitchenStation::~KitchenStation() {
-    for (int i = 0; i < dishes_.size(); i++) {
-        delete dishes_[i];
-        dishes_[i] = nullptr;
-    }
+    //Each shared recipe deletes itself with its last reference
+    dishes_.clear();
 }
 
 /**
@@ -44,24 +42,63 @@ KitchenStation::~KitchenStation() {
 * @return: The name of the station.
 */
 std::string KitchenStation::getName() const {
+    std::lock_guard<std::mutex> lock(name_mutex_);
     return station_name_;
 }
 
 /**
 * Sets the name of the kitchen station.
 * @param name A string representing the new station name.
-* @post: Updates the station's name.
+* @post: Updates the station's name, unless the rename listener refuses
+it.
+* @return: True if the name was updated; false otherwise.
 */
-void KitchenStation::setName(const std::string& name) {
+bool KitchenStation::setName(const std::string& name) {
+    RenameListener listener;
+    {
+        std::shared_lock<std::shared_mutex> lock(station_mutex_);
+        listener = rename_listener_;
+    }
+
+    //Asked without the lock, since a manager reads the station's name back
+    if (listener && !listener(this, name))
+        return false;
+
+    std::lock_guard<std::mutex> lock(name_mutex_);
     station_name_ = name;
+    return true;
 }
 
 /**
 * Retrieves the list of dishes assigned to the kitchen station.
-* @return A vector of pointers to Dish objects assigned to the station.
+* @return A vector of pointers to the Dish objects assigned to the station.
+*/
+std::vector<const Dish*> KitchenStation::getDishes() const {
+    std::shared_lock<std::shared_mutex> lock(station_mutex_);
+    std::vector<const Dish*> dishes;
+
+    for (size_t i = 0; i < dishes_.size(); i++)
+        dishes.push_back(dishes_[i].get());
+
+    return dishes;
+}
+
+/**
+* Retrieves the catalog id of each dish assigned to the station.
+* @return: The ids, in the order of getDishes.
+*/
+std::vector<RecipeCatalog::RecipeId> KitchenStation::getRecipeIds() const {
+    std::shared_lock<std::shared_mutex> lock(station_mutex_);
+    return recipe_ids_;
+}
+
+/**
+* Retrieves the dish id of each dish assigned to the station.
+* @return: The ids, in the order of getDishes.
 */
-std::vector<Dish*> KitchenStation::getDishes() const {
-    return dishes_;
+std::vector<RecipeCatalog::DishId> KitchenStation::getDishIds() const {
+    std::shared_lock<std::shared_mutex> lock(station_mutex_);
+    return dish_ids_;
 }
 
 /**
@@ -70,28 +107,97 @@ std::vector<Dish*> KitchenStation::getDishes() const {
 ingredient stock.
 */
 std::vector<Ingredient> KitchenStation::getIngredientsStock() const {
-    return ingredients_stock_;
+    std::shared_lock<std::shared_mutex> lock(station_mutex_);
+    std::vector<Ingredient> stock;
+
+    //Skipping slots whose ingredient has been depleted
+    for (size_t i = 0; i < stock_names_.size(); i++) {
+        if (!in_stock_[i])
+            continue;
+
+        stock.push_back(Ingredient(stock_names_[i], stock_quantities_[i], stock_required_[i], stock_prices_[i]));
+
+        //The counters hold the live unreserved quantities in the concurrent mode
+        if (concurrent_stock_) {
+            stock.back().quantity = counters_[i].quantity.load(std::memory_order_relaxed) + reserved_[i];
+            if (stock.back().quantity == 0)
+                stock.pop_back();
+        }
+    }
+
+    return stock;
 }
 
 /**
 * Assigns a dish to the station.
-* @param dish A pointer to a Dish object.
-* @post: Adds the dish to the station's list of dishes if not
-already present.
+* @param dish A pointer to a dynamically allocated Dish object.
+* @post: If no dish of that name is present, the station takes ownership
+of dish through the recipe catalog and compiles its recipe against the
+station's stock slots. Otherwise dish is left to the caller.
 * @return: True if the dish was added successfully; false
 otherwise.
 */
 bool KitchenStation::assignDishToStation(Dish* dish) {
-    //Checking if the dish is already present
-    for (int i = 0; i < dishes_.size(); i++) {
-        if (dishes_[i]->getName() == dish->getName()) {
-            return false;
-        }
+    Metrics::Timer timer(metrics_, Metrics::ASSIGN);
+    std::lock_guard<std::shared_mutex> lock(station_mutex_);
+
+    //Checking first so a dish that is not added stays the caller's
+    if (dish_index_.count(dish->getName()) > 0)
+        return false;
+
+    RecipeCatalog::Recipe recipe = RecipeCatalog::instance().intern(dish);
+
+    if (concurrent_stock_)
+        pullCounters();
+
+    bool added = addDish(recipe);
+
+    if (concurrent_stock_)
+        pushCounters();
+
+    if (added && stock_listener_) {
+        StockEvent event;
+        event.type = StockEvent::ASSIGNED;
+        event.dish = recipe.dish.get();
+        stock_listener_(this, event);
     }
 
-    //Since the dish is not present then it gets added to the station
-    dishes_.push_back(dish);
-    return true;
+    return added;
+}
+
+/**
+* Assigns a recipe already in the catalog to the station.
+* @param id The recipe's catalog id.
+* @post: Adds the recipe to the station's list of dishes if it is still
+in the catalog and no dish of that name is present.
+* @return: True if the dish was added successfully; false
+otherwise.
+*/
+bool KitchenStation::assignRecipe(RecipeCatalog::RecipeId id) {
+    Metrics::Timer timer(metrics_, Metrics::ASSIGN);
+    RecipeCatalog::Recipe recipe = RecipeCatalog::instance().find(id);
+
+    if (!recipe.dish)
+        return false;
+
+    std::lock_guard<std::shared_mutex> lock(station_mutex_);
+
+    if (concurrent_stock_)
+        pullCounters();
+
+    bool added = addDish(recipe);
+
+    if (concurrent_stock_)
+        pushCounters();
+
+    if (added && stock_listener_) {
+        StockEvent event;
+        event.type = StockEvent::ASSIGNED;
+        event.dish = recipe.dish.get();
+        stock_listener_(this, event);
+    }
+
+    return added;
 }
 
 /**
@@ -101,20 +207,77 @@ bool KitchenStation::assignDishToStation(Dish* dish) {
 quantity if it already exists.
 */
 void KitchenStation::replenishStationIngredients(const Ingredient& ingredient) {
-    bool update = false;
+    Metrics::Timer timer(metrics_, Metrics::REPLENISH);
+    std::lock_guard<std::shared_mutex> lock(station_mutex_);
 
-    //Checking if the ingredient already exists
-    for (int i = 0; i < ingredients_stock_.size(); i++) {
-        if (ingredients_stock_[i].name == ingredient.name) {
-            //Update the quantity
-            ingredients_stock_[i].quantity+=ingredient.quantity;
-            update = true;
-        }
+    metrics_.add(Metrics::REPLENISHED_UNITS, ingredient.quantity);
+
+    if (concurrent_stock_)
+        pullCounters();
+
+    restock(ingredient);
+
+    if (concurrent_stock_)
+        pushCounters();
+
+    if (stock_listener_) {
+        StockEvent event;
+        event.type = StockEvent::REPLENISHED;
+        event.ingredient = &ingredient;
+        stock_listener_(this, event);
+    }
+}
+
+/**
+* Assigns a recipe without taking the station's lock.
+* @param recipe A recipe from the catalog.
+* @return: True if the dish was added; false if already present.
+*/
+bool KitchenStation::addDish(const RecipeCatalog::Recipe& recipe) {
+    const Dish& dish = *recipe.dish;
+
+    //Checking if the dish is already present
+    if (dish_index_.count(dish.getName()) > 0)
+        return false;
+
+    //Since the dish is not present then it gets added to the station
+    RecipeCatalog::DishId dish_id = RecipeCatalog::instance().registerDish(dish.getName());
+    if (static_cast<size_t>(dish_id) >= dish_by_id_.size())
+        dish_by_id_.resize(dish_id + 1, -1);
+    dish_by_id_[dish_id] = dishes_.size();
+
+    dish_index_.emplace(dish.getName(), dishes_.size());
+    dishes_.push_back(recipe.dish);
+    recipe_ids_.push_back(recipe.id);
+    dish_ids_.push_back(dish_id);
+    recipes_.push_back(compileRecipe(dish, dishes_.size() - 1));
+    servings_.push_back(0);
+    servings_dirty_.push_back(false);
+    setServings(dishes_.size() - 1, computeServings(recipes_.back()));
+    return true;
+}
+
+/**
+* Replenishes the stock without taking the station's lock.
+* @param ingredient An Ingredient object.
+*/
+void KitchenStation::restock(const Ingredient& ingredient) {
+    int slot = bindStockSlot(ingredient.name, ingredient.required_quantity, ingredient.price);
+
+    //Update the quantity if it is in stock; otherwise the slot is stocked as a new entry
+    if (in_stock_[slot])
+        stock_quantities_[slot] += ingredient.quantity;
+    else {
+        stock_quantities_[slot] = ingredient.quantity;
+        stock_required_[slot] = ingredient.required_quantity;
+        stock_prices_[slot] = ingredient.price;
+        in_stock_[slot] = true;
+
+        //The entry's required_quantity may differ, so recipes using it are refreshed
+        refreshNeeds(slot);
     }
 
-    //If the ingredient does not exist then it gets added to the ingredients stock
-    if (!update)
-        ingredients_stock_.push_back(ingredient);
+    refreshServings(slot);
 }
 
 /**
@@ -124,41 +287,89 @@ void KitchenStation::replenishStationIngredients(const Ingredient& ingredient) {
 required ingredients are in stock; false otherwise.
 */
 bool KitchenStation::canCompleteOrder(const std::string& dish_name) {
-    bool found = false;
-    std::vector<Ingredient> ingre = {};
-
-    //Checking if dish_name exist in dishes
-    for (int i = 0; i < dishes_.size(); i++) {
-        if (dishes_[i]->getName() == dish_name) {
-            //Sets ingre to dish_name ingredients
-            ingre = dishes_[i]->getIngredients();
-            break;
-        }
-    }
+    Metrics::Timer timer(metrics_, Metrics::CAN_COMPLETE);
+    reclaimIfDue();
+    std::shared_lock<std::shared_mutex> lock(station_mutex_);
+    return checkDish(findDish(dish_name), true);
+}
 
-    //If ingre is empty then dish_name doesn't exist in dishes
-    if (ingre.size() == 0)
-        return false;
+/**
+* Checks if the station can complete an order for a specific dish.
+* @param dish_id The dish's id in the recipe catalog.
+* @return: As canCompleteOrder by name.
+*/
+bool KitchenStation::canCompleteOrder(RecipeCatalog::DishId dish_id) {
+    Metrics::Timer timer(metrics_, Metrics::CAN_COMPLETE);
+    reclaimIfDue();
+    std::shared_lock<std::shared_mutex> lock(station_mutex_);
+    return checkDish(findDish(dish_id), true);
+}
 
-    //Checking dish_name ingredients is in stock
-    for (int j = 0; j < ingre.size(); j++) {
-        found = false;
+/**
+* Checks many orders against the station under one lock.
+* @param dish_names The names of the dishes.
+* @return: Entry i is canCompleteOrder(dish_names[i]), all answered
+against the same stock.
+*/
+std::vector<bool> KitchenStation::canCompleteOrders(const std::vector<std::string>& dish_names) {
+    Metrics::Timer timer(metrics_, Metrics::CAN_COMPLETE);
+    reclaimIfDue();
+    std::shared_lock<std::shared_mutex> lock(station_mutex_);
+    std::vector<int> dishes(dish_names.size());
 
-        for (int k = 0; k < ingredients_stock_.size(); k++) {
-            if (ingre[j].name == ingredients_stock_[k].name) {
-                if (ingredients_stock_[k].quantity < ingredients_stock_[k].required_quantity)
-                    return false;
+    for (size_t i = 0; i < dish_names.size(); i++)
+        dishes[i] = findDish(dish_names[i]);
 
-                found = true;
-            }
-        }
+    return checkDishes(dishes, true);
+}
 
-        //Checking if dish_name ingredients exists in ingredients_stock
-        if (!found)
-            return false; //dish_name did not exist
-    }
+/**
+* Checks many orders against the station under one lock.
+* @param dish_ids The dishes' ids in the recipe catalog.
+* @return: Entry i is canCompleteOrder(dish_ids[i]), all answered
+against the same stock.
+*/
+std::vector<bool> KitchenStation::canCompleteOrders(const std::vector<RecipeCatalog::DishId>& dish_ids) {
+    Metrics::Timer timer(metrics_, Metrics::CAN_COMPLETE);
+    reclaimIfDue();
+    std::shared_lock<std::shared_mutex> lock(station_mutex_);
+    std::vector<int> dishes(dish_ids.size());
 
-    return true;
+    for (size_t i = 0; i < dish_ids.size(); i++)
+        dishes[i] = findDish(dish_ids[i]);
+
+    return checkDishes(dishes, true);
+}
+
+/**
+* Checks if the station can complete an order for a specific dish,
+for routing scans that ask every station: the check is neither timed
+nor counted in the station's metrics.
+* @param dish_id The dish's id in the recipe catalog.
+* @return: As canCompleteOrder.
+*/
+bool KitchenStation::isAvailable(RecipeCatalog::DishId dish_id) {
+    reclaimIfDue();
+    std::shared_lock<std::shared_mutex> lock(station_mutex_);
+    return checkDish(findDish(dish_id), false);
+}
+
+/**
+* Checks many orders against the station under one lock, uncounted
+like isAvailable.
+* @param dish_ids The dishes' ids in the recipe catalog.
+* @return: Entry i is isAvailable(dish_ids[i]), all answered against
+the same stock.
+*/
+std::vector<bool> KitchenStation::areAvailable(const std::vector<RecipeCatalog::DishId>& dish_ids) {
+    reclaimIfDue();
+    std::shared_lock<std::shared_mutex> lock(station_mutex_);
+    std::vector<int> dishes(dish_ids.size());
+
+    for (size_t i = 0; i < dish_ids.size(); i++)
+        dishes[i] = findDish(dish_ids[i]);
+
+    return checkDishes(dishes, false);
 }
 
 /**
@@ -171,32 +382,1344 @@ used ingredients accordingly. If the stock ingredient is depleted to
 otherwise.
 */
 bool KitchenStation::prepareDish(const std::string& dish_name) {
-    //Early check if dish_name can be created
-    if (!canCompleteOrder(dish_name)) 
-        return false;
+    return tryPrepare(dish_name).prepared;
+}
+
+/**
+* Prepares a dish if possible.
+* @param dish_id The dish's id in the recipe catalog.
+* @post: As prepareDish by name.
+* @return: True if the dish was prepared successfully; false
+otherwise.
+*/
+bool KitchenStation::prepareDish(RecipeCatalog::DishId dish_id) {
+    return tryPrepare(dish_id).prepared;
+}
+
+/**
+* Prepares a dish if possible, checking and deducting the stock in
+one pass while holding the station's lock.
+* @param dish_name A string representing the name of the dish.
+* @post: Either every ingredient of the dish is deducted (depleted
+ingredients are removed from the stock) or the stock is left exactly
+as it was; no other caller can observe a partial deduction.
+* @return: The outcome, listing every ingredient that fell short when
+the dish could not be prepared.
+*/
+KitchenStation::PrepareResult KitchenStation::tryPrepare(const std::string& dish_name) {
+    return prepareLocked(&dish_name, -1);
+}
+
+/**
+* Prepares a dish if possible, checking and deducting the stock in
+one pass while holding the station's lock.
+* @param dish_id The dish's id in the recipe catalog.
+* @return: As tryPrepare by name.
+*/
+KitchenStation::PrepareResult KitchenStation::tryPrepare(RecipeCatalog::DishId dish_id) {
+    return prepareLocked(nullptr, dish_id);
+}
+
+/**
+* Prepares a dish under the station's lock, in whichever stock mode is
+on when the lock is taken.
+* @param dish_name The name of the dish, or nullptr to look it up by
+dish_id instead.
+* @param dish_id The dish's id in the recipe catalog; used only if
+dish_name is nullptr.
+* @return: The outcome, as tryPrepare.
+*/
+KitchenStation::PrepareResult KitchenStation::prepareLocked(const std::string* dish_name, RecipeCatalog::DishId dish_id) {
+    Metrics::Timer timer(metrics_, Metrics::PREPARE);
+
+    //In the concurrent mode orders only share the lock and claim ingredients with CAS
+    if (concurrent_stock_) {
+        reclaimIfDue();
+        std::shared_lock<std::shared_mutex> lock(station_mutex_);
+
+        if (concurrent_stock_) {
+            PrepareResult result = prepareFromCounters(dish_name ? findDish(*dish_name) : findDish(dish_id));
+
+            //Some dish may have become unavailable; only the users of the crossed slots are recounted, still under the shared lock
+            recountCrossed();
+            lock.unlock();
+
+            if (!result.prepared)
+                metrics_.add(Metrics::ORDERS_REJECTED);
+            return result;
+        }
+    }
 
-    std::vector<Ingredient> ingre = {};
+    std::lock_guard<std::shared_mutex> lock(station_mutex_);
+    int dish = dish_name ? findDish(*dish_name) : findDish(dish_id);
 
-    //Gets dish_name ingredients and storing them in ingre
-    for (int i = 0; i < dishes_.size(); i++) {
-        if (dishes_[i]->getName() == dish_name)
-            ingre = dishes_[i]->getIngredients();
+    //The mode may have been turned on while waiting for the lock
+    if (concurrent_stock_) {
+        PrepareResult result = prepareFromCounters(dish);
+        recountCrossed();
+        if (!result.prepared)
+            metrics_.add(Metrics::ORDERS_REJECTED);
+        return result;
     }
 
-    //Updates the ingredients stock quantity
-    for (int j = 0; j < ingre.size(); j++) {
-        for (int k = 0; k < ingredients_stock_.size(); k++) {
-            if (ingre[j].name == ingredients_stock_[k].name) {
-                ingredients_stock_[k].quantity-=ingredients_stock_[k].required_quantity;
+    reclaimExpired();
+    PrepareResult result = prepareFromStock(dish);
+    if (!result.prepared)
+        metrics_.add(Metrics::ORDERS_REJECTED);
+    return result;
+}
+
+/**
+* Prepares a dish from the stock arrays. The caller holds the
+station's lock exclusively.
+* @param dish The dish's index in dishes_, or -1 if not assigned.
+* @return: The outcome, as tryPrepare.
+*/
+KitchenStation::PrepareResult KitchenStation::prepareFromStock(int dish) {
+    PrepareResult result;
+
+    if (dish == -1)
+        return result;
+
+    result.dish_assigned = true;
+    const CompiledRecipe& recipe = recipes_[dish];
+
+    //A dish without ingredients cannot be ordered
+    if (recipe.slots.size() == 0)
+        return result;
+
+    //Checking every ingredient at once; only a failed check walks the recipe again for the report
+    if (countShort(recipe) > 0) {
+        for (size_t j = 0; j < recipe.slots.size(); j++) {
+            int slot = recipe.slots[j];
+            int available = unreserved(slot);
+
+            if (!in_stock_[slot] || available < recipe.needs[j])
+                result.shortfalls.push_back(Shortfall{stock_names_[slot], recipe.needs[j], available});
+        }
+
+        return result;
+    }
+
+    deduct(recipe, 1);
+    result.prepared = true;
+
+    for (size_t j = 0; j < recipe.slots.size(); j++)
+        refreshServings(recipe.slots[j]);
+    reportPrepared(dish, 1);
+
+    return result;
+}
 
-                //Remove the ingredient from the stock if the quantity is 0
-                if (ingredients_stock_[k].quantity == 0)
-                    ingredients_stock_.erase(ingredients_stock_.begin() + k);
+/**
+* Prepares a burst of orders at once.
+* @param orders (dish name, servings) pairs.
+* @post: The total demand of every ingredient is added up and
+checked against the stock once. If everything fits, every order is
+prepared; otherwise orders are filled in the given sequence with as
+many servings as the remaining stock allows. The stock is deducted
+once per ingredient and depleted ingredients are removed.
+* @return: The number of servings prepared for each order, in the same
+sequence as orders (0 for unassigned dishes).
+*/
+std::vector<int> KitchenStation::prepareBatch(const std::vector<std::pair<std::string, int>>& orders) {
+    Metrics::Timer timer(metrics_, Metrics::PREPARE_BATCH);
+    std::lock_guard<std::shared_mutex> lock(station_mutex_);
+
+    if (concurrent_stock_)
+        pullCounters();
+
+    reclaimExpired();
+
+    std::vector<int> prepared(orders.size(), 0);
+    std::vector<int> dishes(orders.size(), -1);
+    std::vector<long long> demand(stock_names_.size(), 0);
+    std::vector<bool> seen(stock_names_.size(), false);
+    std::vector<int> touched;
+
+    //Adding up the demand of every ingredient across the batch
+    for (size_t i = 0; i < orders.size(); i++) {
+        int dish = findDish(orders[i].first);
+
+        if (dish == -1 || orders[i].second <= 0 || recipes_[dish].slots.size() == 0)
+            continue;
+
+        dishes[i] = dish;
+        const CompiledRecipe& recipe = recipes_[dish];
+
+        for (size_t j = 0; j < recipe.slots.size(); j++) {
+            if (!seen[recipe.slots[j]]) {
+                seen[recipe.slots[j]] = true;
+                touched.push_back(recipe.slots[j]);
             }
+            demand[recipe.slots[j]] += (long long)recipe.needs[j] * orders[i].second;
         }
     }
 
-    return true;
+    //One feasibility check for the whole batch, without early exit
+    int short_slots = 0;
+    for (size_t k = 0; k < touched.size(); k++) {
+        int slot = touched[k];
+        short_slots += (in_stock_[slot] == 0) | (stock_quantities_[slot] - reserved_[slot] < demand[slot]);
+    }
+    bool feasible = short_slots == 0;
+
+    if (feasible) {
+        for (size_t i = 0; i < orders.size(); i++) {
+            if (dishes[i] != -1)
+                prepared[i] = orders[i].second;
+        }
+    }
+    else {
+        //Reusing demand as the stock left for the remaining orders
+        for (size_t k = 0; k < touched.size(); k++) {
+            int slot = touched[k];
+            demand[slot] = unreserved(slot);
+        }
+
+        //Filling orders in sequence with as many servings as still fit
+        for (size_t i = 0; i < orders.size(); i++) {
+            if (dishes[i] == -1)
+                continue;
+
+            const CompiledRecipe& recipe = recipes_[dishes[i]];
+            long long servings = orders[i].second;
+
+            for (size_t j = 0; j < recipe.slots.size() && servings > 0; j++) {
+                if (!in_stock_[recipe.slots[j]])
+                    servings = 0;
+                else if (recipe.needs[j] > 0)
+                    servings = std::min(servings, demand[recipe.slots[j]] / recipe.needs[j]);
+            }
+
+            for (size_t j = 0; j < recipe.slots.size(); j++)
+                demand[recipe.slots[j]] -= recipe.needs[j] * servings;
+
+            prepared[i] = servings;
+        }
+
+        //Turning what is left back into the amount used
+        for (size_t k = 0; k < touched.size(); k++) {
+            int slot = touched[k];
+            demand[slot] = unreserved(slot) - demand[slot];
+        }
+    }
+
+    //Deducting once per ingredient
+    for (size_t k = 0; k < touched.size(); k++) {
+        int slot = touched[k];
+
+        if (demand[slot] == 0 || !in_stock_[slot])
+            continue;
+
+        stock_quantities_[slot] -= demand[slot];
+
+        //Remove the ingredient from the stock if the quantity is 0
+        if (stock_quantities_[slot] == 0) {
+            in_stock_[slot] = false;
+            metrics_.add(Metrics::STOCK_OUTS);
+        }
+
+        refreshServings(slot);
+    }
+
+    if (concurrent_stock_)
+        pushCounters();
+
+    for (size_t i = 0; i < orders.size(); i++) {
+        if (prepared[i] > 0)
+            reportPrepared(dishes[i], prepared[i]);
+        else
+            metrics_.add(Metrics::ORDERS_REJECTED);
+    }
+
+    return prepared;
+}
+
+/**
+* Moves the dishes and ingredient stock of another station into
+this station.
+* @param other The station being merged into this one.
+* @post: Dishes not already assigned here are transferred (ownership
+included) and ingredient quantities are added to the stock. Dishes
+already present stay in other, which is left with no stock. Other's
+reservations are released, not moved: what they held becomes free stock
+here and their handles are no longer held by either station.
+*/
+void KitchenStation::absorb(KitchenStation&& other) {
+    if (&other == this)
+        return;
+
+    std::scoped_lock lock(station_mutex_, other.station_mutex_);
+
+    if (concurrent_stock_)
+        pullCounters();
+    if (other.concurrent_stock_)
+        other.pullCounters();
+
+    //Adding quantities to existing ingredients and moving the rest over
+    for (size_t i = 0; i < other.stock_names_.size(); i++) {
+        if (!other.in_stock_[i])
+            continue;
+
+        auto found = stock_slots_.find(other.stock_names_[i]);
+
+        if (found == stock_slots_.end()) {
+            stock_slots_.emplace(other.stock_names_[i], stock_names_.size());
+            stock_names_.push_back(std::move(other.stock_names_[i]));
+            stock_quantities_.push_back(other.stock_quantities_[i]);
+            stock_required_.push_back(other.stock_required_[i]);
+            stock_prices_.push_back(other.stock_prices_[i]);
+            in_stock_.push_back(true);
+            reserved_.push_back(0);
+            slot_users_.emplace_back();
+        }
+        else
+            restock(Ingredient(other.stock_names_[i], other.stock_quantities_[i], other.stock_required_[i], other.stock_prices_[i]));
+    }
+    other.stock_names_.clear();
+    other.stock_quantities_.clear();
+    other.stock_required_.clear();
+    other.stock_prices_.clear();
+    other.in_stock_.clear();
+    other.reserved_.clear();
+    //Other's reservations are released rather than moved; their quantities were counted in the stock added above
+    other.reservations_.clear();
+    other.next_expiry_.store(LLONG_MAX);
+    other.stock_slots_.clear();
+    other.slot_users_.clear();
+
+    //Taking over the dishes this station does not have yet; the rest stay with other
+    std::vector<std::shared_ptr<const Dish>> dishes = std::move(other.dishes_);
+    std::vector<RecipeCatalog::RecipeId> recipe_ids = std::move(other.recipe_ids_);
+    other.dishes_.clear();
+    other.recipe_ids_.clear();
+    other.recipes_.clear();
+    other.dish_index_.clear();
+    other.dish_ids_.clear();
+    other.dish_by_id_.clear();
+    other.servings_.clear();
+    other.servings_dirty_.clear();
+    other.changed_dishes_.clear();
+
+    for (size_t i = 0; i < dishes.size(); i++) {
+        RecipeCatalog::Recipe recipe{recipe_ids[i], std::move(dishes[i])};
+
+        if (!addDish(recipe))
+            other.addDish(recipe);
+    }
+
+    if (concurrent_stock_)
+        pushCounters();
+    if (other.concurrent_stock_)
+        other.pushCounters();
+}
+
+/**
+* Holds the ingredients of some servings of a dish for an order that will
+be cooked later.
+* @param dish_name A string representing the name of the dish.
+* @param servings The number of servings to hold.
+* @param ttl How long the hold lasts before it is released on its own.
+* @post: The ingredients stay in the stock but no other order can use
+them until the reservation is committed, released or expires.
+* @return: A handle for commit/release; 0 if the dish is not assigned,
+servings is not positive, or the unreserved stock is short.
+*/
+KitchenStation::ReservationHandle KitchenStation::reserve(const std::string& dish_name, int servings, std::chrono::milliseconds ttl) {
+    Metrics::Timer timer(metrics_, Metrics::RESERVE);
+    std::lock_guard<std::shared_mutex> lock(station_mutex_);
+
+    if (concurrent_stock_)
+        pullCounters();
+
+    reclaimExpired();
+
+    ReservationHandle handle = 0;
+    int dish = findDish(dish_name);
+
+    //servings_ already leaves out what other reservations hold
+    if (dish != -1 && servings > 0 && servings_[dish] >= servings) {
+        const CompiledRecipe& recipe = recipes_[dish];
+        //Rounding the ttl up, plus one tick for the part of this tick already gone, so it never expires early
+        long long ticks = (ttl.count() + RESERVATION_TICK.count() - 1) / RESERVATION_TICK.count();
+        Reservation reservation{dish, servings, recipe.slots, std::vector<int>(recipe.slots.size()), reservationTick() + ticks + 1};
+
+        for (size_t j = 0; j < recipe.slots.size(); j++) {
+            reservation.amounts[j] = recipe.needs[j] * servings;
+            reserved_[recipe.slots[j]] += reservation.amounts[j];
+        }
+
+        for (size_t j = 0; j < recipe.slots.size(); j++)
+            refreshServings(recipe.slots[j]);
+
+        handle = next_reservation_++;
+        reservation_timers_.schedule(handle, reservation.deadline);
+        if (reservation.deadline < next_expiry_.load())
+            next_expiry_.store(reservation.deadline);
+        reservations_.emplace(handle, std::move(reservation));
+    }
+
+    if (concurrent_stock_)
+        pushCounters();
+
+    return handle;
+}
+
+/**
+* Cooks a reservation.
+* @param handle A handle returned by reserve.
+* @post: The held ingredients are deducted as if the servings were
+prepared (depleted ingredients are removed from the stock).
+* @return: True if the reservation was still held; false if it was
+already committed, released or expired.
+*/
+bool KitchenStation::commit(ReservationHandle handle) {
+    Metrics::Timer timer(metrics_, Metrics::COMMIT);
+    std::lock_guard<std::shared_mutex> lock(station_mutex_);
+
+    if (concurrent_stock_)
+        pullCounters();
+
+    reclaimExpired();
+
+    auto found = reservations_.find(handle);
+    bool committed = found != reservations_.end();
+
+    if (committed) {
+        const Reservation& reservation = found->second;
+
+        for (size_t j = 0; j < reservation.slots.size(); j++) {
+            int slot = reservation.slots[j];
+            stock_quantities_[slot] -= reservation.amounts[j];
+            reserved_[slot] -= reservation.amounts[j];
+
+            //Remove the ingredient from the stock if the quantity is 0
+            if (stock_quantities_[slot] == 0) {
+                in_stock_[slot] = false;
+                metrics_.add(Metrics::STOCK_OUTS);
+            }
+        }
+
+        for (size_t j = 0; j < reservation.slots.size(); j++)
+            refreshServings(reservation.slots[j]);
+
+        reportPrepared(reservation.dish, reservation.servings);
+        reservations_.erase(found);
+    }
+
+    if (concurrent_stock_)
+        pushCounters();
+
+    return committed;
+}
+
+/**
+* Gives up a reservation.
+* @param handle A handle returned by reserve.
+* @post: The held ingredients are available to other orders again.
+* @return: True if the reservation was still held; false otherwise.
+*/
+bool KitchenStation::release(ReservationHandle handle) {
+    std::lock_guard<std::shared_mutex> lock(station_mutex_);
+
+    if (concurrent_stock_)
+        pullCounters();
+
+    reclaimExpired();
+
+    bool released = reservations_.count(handle) > 0;
+    if (released)
+        dropReservation(handle);
+
+    if (concurrent_stock_)
+        pushCounters();
+
+    return released;
+}
+
+/**
+* Releases every reservation whose ttl has run out.
+* @return: The number of reservations released.
+*/
+int KitchenStation::expireReservations() {
+    std::lock_guard<std::shared_mutex> lock(station_mutex_);
+
+    if (concurrent_stock_)
+        pullCounters();
+
+    int expired = reclaimExpired();
+
+    if (concurrent_stock_)
+        pushCounters();
+
+    return expired;
+}
+
+/**
+* Retrieves how many more servings of a dish the station can make.
+* @param dish_name A string representing the name of the dish.
+* @return: The servings remaining; 0 if the dish is not assigned.
+*/
+int KitchenStation::servingsRemaining(const std::string& dish_name) const {
+    std::shared_lock<std::shared_mutex> lock(station_mutex_);
+    int dish = findDish(dish_name);
+
+    if (dish == -1)
+        return 0;
+
+    if (concurrent_stock_)
+        return counterServings(recipes_[dish]);
+
+    return servings_[dish];
+}
+
+/**
+* Retrieves the prep time of an assigned dish.
+* @param dish_name A string representing the name of the dish.
+* @return: The dish's prep time; -1 if the dish is not assigned.
+*/
+int KitchenStation::getPrepTime(const std::string& dish_name) const {
+    std::shared_lock<std::shared_mutex> lock(station_mutex_);
+    int dish = findDish(dish_name);
+
+    if (dish == -1)
+        return -1;
+
+    return dishes_[dish]->getPrepTime();
+}
+
+/**
+* Retrieves the servings remaining of every assigned dish.
+* @return: (dish name, servings remaining) pairs in assignment order.
+*/
+std::vector<std::pair<std::string, int>> KitchenStation::getServingsBoard() const {
+    std::shared_lock<std::shared_mutex> lock(station_mutex_);
+    std::vector<std::pair<std::string, int>> board;
+
+    for (size_t i = 0; i < dishes_.size(); i++)
+        board.push_back(std::make_pair(dishes_[i]->getName(), concurrent_stock_ ? counterServings(recipes_[i]) : servings_[i]));
+
+    return board;
+}
+
+/**
+* Works out what forecast servings of the station's dishes would leave of
+the stock.
+* @param demand Servings forecast for each dish, indexed by dish id.
+* @post: The entries of the station's dishes in demand are set to 0.
+* @return: The balance of every stock slot.
+*/
+KitchenStation::StockForecast KitchenStation::forecastStock(std::vector<int>& demand) const {
+    std::shared_lock<std::shared_mutex> lock(station_mutex_);
+    int slot_count = stock_names_.size();
+    std::vector<int> needed(slot_count, 0);
+
+    //Scattering the needs of every dish with forecast servings; a recipe's slots are distinct
+    for (size_t i = 0; i < dishes_.size(); i++) {
+        RecipeCatalog::DishId id = dish_ids_[i];
+        if (static_cast<size_t>(id) >= demand.size() || demand[id] <= 0)
+            continue;
+
+        const CompiledRecipe& recipe = recipes_[i];
+        int servings = demand[id];
+        demand[id] = 0;
+
+        for (size_t j = 0; j < recipe.slots.size(); j++)
+            needed[recipe.slots[j]] += recipe.needs[j] * servings;
+    }
+
+    StockForecast forecast;
+    forecast.ingredients = stock_names_;
+    forecast.required = stock_required_;
+    forecast.prices = stock_prices_;
+    forecast.balances.resize(slot_count);
+
+    int* __restrict balances = forecast.balances.data();
+    const int* __restrict needs = needed.data();
+
+    //The counters hold the live unreserved quantities in the concurrent mode
+    if (concurrent_stock_) {
+        for (int k = 0; k < slot_count; k++)
+            balances[k] = counters_[k].quantity.load(std::memory_order_relaxed) - needs[k];
+        return forecast;
+    }
+
+    const int* __restrict quantities = stock_quantities_.data();
+    const int* __restrict reserved = reserved_.data();
+    const int* __restrict in_stock = in_stock_.data();
+
+    //One pass over the stock arrays without branching; the arrays never overlap, so with VECFLAGS it vectorizes without alias checks
+#pragma GCC ivdep
+    for (int k = 0; k < slot_count; k++)
+        balances[k] = (quantities[k] - reserved[k]) * in_stock[k] - needs[k];
+
+    return forecast;
+}
+
+/**
+* Retrieves the dishes whose servings remaining changed since the last
+call.
+* @post: The set of changed dishes is emptied.
+* @return: (dish name, servings remaining) pairs, one per changed dish.
+*/
+std::vector<std::pair<std::string, int>> KitchenStation::takeServingsChanges() {
+    std::lock_guard<std::shared_mutex> lock(station_mutex_);
+    std::vector<std::pair<std::string, int>> changes;
+
+    if (concurrent_stock_)
+        pullCounters();
+
+    for (size_t i = 0; i < changed_dishes_.size(); i++) {
+        int dish = changed_dishes_[i];
+        servings_dirty_[dish] = false;
+        changes.push_back(std::make_pair(dishes_[dish]->getName(), servings_[dish]));
+    }
+    changed_dishes_.clear();
+
+    return changes;
+}
+
+/**
+* Sets the callback told about availability changes.
+* @param listener The callback, or nullptr to stop notifications.
+* @post: Every later flip of a dish's canCompleteOrder answer caused by
+assigning, replenishing, preparing or absorbing is reported.
+*/
+void KitchenStation::setAvailabilityListener(AvailabilityListener listener) {
+    std::lock_guard<std::shared_mutex> lock(station_mutex_);
+    availability_listener_ = listener;
+}
+
+/**
+* Sets the callback told about changes to the dishes and stock.
+* @param listener The callback, or nullptr to stop notifications.
+*/
+void KitchenStation::setStockListener(StockListener listener) {
+    std::lock_guard<std::shared_mutex> lock(station_mutex_);
+    stock_listener_ = listener;
+}
+
+/**
+* Sets the callback asked before every rename.
+* @param listener The callback, or nullptr to rename freely.
+*/
+void KitchenStation::setRenameListener(RenameListener listener) {
+    std::lock_guard<std::shared_mutex> lock(station_mutex_);
+    rename_listener_ = listener;
+}
+
+/**
+* Switches the station's stock between the locked mode and the
+concurrent mode.
+* @param enabled True to turn the concurrent mode on; false to fold the
+counters back into the stock.
+* @post: While enabled, availability changes caused by preparing are
+reported when an order drops an ingredient below what some dish needs.
+*/
+void KitchenStation::setConcurrentStock(bool enabled) {
+    std::lock_guard<std::shared_mutex> lock(station_mutex_);
+
+    if (enabled == concurrent_stock_)
+        return;
+
+    if (enabled)
+        pushCounters();
+    else {
+        pullCounters();
+        counters_.reset();
+        counter_count_ = 0;
+        slot_thresholds_.clear();
+    }
+
+    concurrent_stock_ = enabled;
+}
+
+/**
+* Checks whether the concurrent stock mode is on.
+* @return: True if quantities are kept in atomic counters.
+*/
+bool KitchenStation::concurrentStock() const {
+    return concurrent_stock_;
+}
+
+/**
+* Retrieves the station's operation counters and latency histograms.
+* @return: The station's metrics.
+*/
+const Metrics& KitchenStation::metrics() const {
+    return metrics_;
+}
+
+/**
+* Looks up an ingredient that is currently in stock.
+* @param ingredient_name A string representing the ingredient's name.
+* @return: The ingredient's slot if it is in stock; -1 otherwise.
+*/
+int KitchenStation::findStockSlot(const std::string& ingredient_name) const {
+    auto found = stock_slots_.find(ingredient_name);
+
+    if (found == stock_slots_.end() || !in_stock_[found->second])
+        return -1;
+
+    return found->second;
+}
+
+/**
+* Looks up an assigned dish.
+* @param dish_name A string representing the name of the dish.
+* @return: The dish's index in dishes_ if assigned; -1 otherwise.
+*/
+int KitchenStation::findDish(const std::string& dish_name) const {
+    auto found = dish_index_.find(dish_name);
+
+    if (found == dish_index_.end())
+        return -1;
+
+    return found->second;
+}
+
+/**
+* Looks up an assigned dish by id.
+* @param dish_id The dish's id in the recipe catalog.
+* @return: The dish's index in dishes_ if assigned; -1 otherwise.
+*/
+int KitchenStation::findDish(RecipeCatalog::DishId dish_id) const {
+    if (dish_id < 0 || static_cast<size_t>(dish_id) >= dish_by_id_.size())
+        return -1;
+
+    return dish_by_id_[dish_id];
+}
+
+/**
+* Checks an assigned dish. The caller holds the station's lock, shared
+or exclusive.
+* @param dish The dish's index in dishes_, or -1 if not assigned.
+* @param counted Whether a failed check is counted in the metrics.
+* @return: As canCompleteOrder.
+*/
+bool KitchenStation::checkDish(int dish, bool counted) {
+    //Checking if the dish exist in dishes
+    if (dish == -1) {
+        if (counted)
+            metrics_.add(Metrics::ORDER_CHECKS_FAILED);
+        return false;
+    }
+
+    bool can_complete = (concurrent_stock_ ? counterServings(recipes_[dish]) : servings_[dish]) > 0;
+
+    if (!can_complete && counted) {
+        metrics_.add(Metrics::ORDER_CHECKS_FAILED);
+        reportMissing(dish);
+    }
+
+    return can_complete;
+}
+
+/**
+* Checks many assigned dishes against one view of the stock. The caller
+holds the station's lock, shared or exclusive.
+* @param dishes Indices in dishes_; -1 for dishes not assigned.
+* @param counted Whether failed checks are counted in the metrics.
+* @return: Entry i is checkDish(dishes[i], counted).
+*/
+std::vector<bool> KitchenStation::checkDishes(const std::vector<int>& dishes, bool counted) {
+    std::vector<bool> can_complete(dishes.size(), false);
+    std::vector<int> available;
+
+    //In the concurrent mode the counters are read once into a snapshot every dish is checked against; -1 marks a depleted slot
+    if (concurrent_stock_) {
+        available.resize(counter_count_);
+        for (size_t i = 0; i < counter_count_; i++)
+            available[i] = in_stock_[i] ? counters_[i].quantity.load(std::memory_order_relaxed) : -1;
+    }
+
+    for (size_t i = 0; i < dishes.size(); i++) {
+        int dish = dishes[i];
+
+        if (dish == -1) {
+            if (counted)
+                metrics_.add(Metrics::ORDER_CHECKS_FAILED);
+            continue;
+        }
+
+        if (!concurrent_stock_)
+            can_complete[i] = servings_[dish] > 0;
+        else {
+            const CompiledRecipe& recipe = recipes_[dish];
+            int shorts = 0;
+
+            //A dish without ingredients cannot be ordered
+            for (size_t j = 0; j < recipe.slots.size(); j++)
+                shorts += available[recipe.slots[j]] < recipe.needs[j];
+            can_complete[i] = recipe.slots.size() > 0 && shorts == 0;
+        }
+
+        if (!can_complete[i] && counted) {
+            metrics_.add(Metrics::ORDER_CHECKS_FAILED);
+            reportMissing(dish);
+        }
+    }
+
+    return can_complete;
+}
+
+/**
+* Returns the stock slot of an ingredient, creating an empty one if
+the ingredient was never stocked.
+* @param ingredient_name A string representing the ingredient's name.
+* @param required_quantity The required_quantity of a new slot.
+* @param price The price of a new slot until it is stocked.
+* @return: The ingredient's slot; a new slot starts out of stock.
+*/
+int KitchenStation::bindStockSlot(const std::string& ingredient_name, int required_quantity, double price) {
+    auto found = stock_slots_.find(ingredient_name);
+
+    if (found != stock_slots_.end())
+        return found->second;
+
+    int slot = stock_names_.size();
+    stock_slots_.emplace(ingredient_name, slot);
+    stock_names_.push_back(ingredient_name);
+    stock_quantities_.push_back(0);
+    stock_required_.push_back(required_quantity);
+    stock_prices_.push_back(price);
+    in_stock_.push_back(false);
+    reserved_.push_back(0);
+    slot_users_.emplace_back();
+    return slot;
+}
+
+/**
+* Compiles a dish's ingredient list into stock slots.
+* @param dish The dish to compile.
+* @param dish_index The dish's index in dishes_.
+* @post: Every ingredient is bound to a stock slot and the dish is
+registered as a user of those slots.
+* @return: The compiled recipe, with repeated ingredients combined.
+*/
+KitchenStation::CompiledRecipe KitchenStation::compileRecipe(const Dish& dish, int dish_index) {
+    CompiledRecipe recipe;
+    std::vector<Ingredient> ingre = dish.getIngredients();
+
+    for (size_t i = 0; i < ingre.size(); i++) {
+        int slot = bindStockSlot(ingre[i].name, ingre[i].required_quantity, ingre[i].price);
+        size_t j = 0;
+
+        //Combining an ingredient listed more than once into one entry
+        while (j < recipe.slots.size() && recipe.slots[j] != slot)
+            j++;
+
+        if (j == recipe.slots.size()) {
+            recipe.slots.push_back(slot);
+            recipe.uses.push_back(0);
+            recipe.needs.push_back(0);
+            slot_users_[slot].push_back(dish_index);
+        }
+
+        recipe.uses[j]++;
+        recipe.needs[j] = recipe.uses[j] * stock_required_[slot];
+    }
+
+    //Keeping entries in slot order so concurrent orders claim shared ingredients in the same order
+    std::vector<int> order(recipe.slots.size());
+    for (size_t j = 0; j < order.size(); j++)
+        order[j] = j;
+    std::sort(order.begin(), order.end(), [&recipe](int a, int b) { return recipe.slots[a] < recipe.slots[b]; });
+
+    CompiledRecipe sorted;
+    for (size_t j = 0; j < order.size(); j++) {
+        sorted.slots.push_back(recipe.slots[order[j]]);
+        sorted.uses.push_back(recipe.uses[order[j]]);
+        sorted.needs.push_back(recipe.needs[order[j]]);
+    }
+
+    return sorted;
+}
+
+/**
+* Recomputes the required quantities that depend on a stock slot.
+* @param slot The stock slot whose entry was replaced.
+* @post: Every compiled recipe using slot needs the slot's current
+required_quantity per use.
+*/
+void KitchenStation::refreshNeeds(int slot) {
+    for (size_t d = 0; d < slot_users_[slot].size(); d++) {
+        CompiledRecipe& recipe = recipes_[slot_users_[slot][d]];
+
+        for (size_t j = 0; j < recipe.slots.size(); j++) {
+            if (recipe.slots[j] == slot)
+                recipe.needs[j] = recipe.uses[j] * stock_required_[slot];
+        }
+    }
+}
+
+/**
+* Counts the servings a compiled recipe can still make from the stock.
+* @param recipe The compiled recipe of an assigned dish.
+* @return: The minimum over the recipe of quantity / needed quantity;
+0 if the recipe is empty or uses an ingredient that is out of stock.
+*/
+int KitchenStation::computeServings(const CompiledRecipe& recipe) const {
+    //A dish without ingredients cannot be ordered
+    if (recipe.slots.size() == 0)
+        return 0;
+
+    const int* slots = recipe.slots.data();
+    const int* needs = recipe.needs.data();
+    const int* quantities = stock_quantities_.data();
+    const int* reserved = reserved_.data();
+    const int* in_stock = in_stock_.data();
+    int count = recipe.slots.size();
+    int servings = INT_MAX;
+    int missing = 0;
+
+    //Scalar: x86 has no vector integer division, and GCC 12 will not vectorize a min of quotients in floating point either
+    for (int j = 0; j < count; j++) {
+        int slot = slots[j];
+        int need = needs[j];
+
+        missing |= in_stock[slot] == 0;
+        servings = std::min(servings, need > 0 ? (quantities[slot] - reserved[slot]) / need : INT_MAX);
+    }
+
+    return missing ? 0 : std::max(servings, 0);
+}
+
+/**
+* Retrieves the quantity of a stock slot that orders can use.
+* @param slot The stock slot.
+* @return: The quantity not held by reservations; 0 if the slot is out of
+stock.
+*/
+int KitchenStation::unreserved(int slot) const {
+    return in_stock_[slot] ? stock_quantities_[slot] - reserved_[slot] : 0;
+}
+
+/**
+* Counts the entries of a compiled recipe the unreserved stock cannot
+cover.
+* @param recipe The compiled recipe of an assigned dish.
+* @return: The number of entries whose slot is out of stock or holds less
+than the entry needs; 0 if one serving can be made.
+*/
+int KitchenStation::countShort(const CompiledRecipe& recipe) const {
+    const int* __restrict slots = recipe.slots.data();
+    const int* __restrict needs = recipe.needs.data();
+    const int* __restrict quantities = stock_quantities_.data();
+    const int* __restrict reserved = reserved_.data();
+    const int* __restrict in_stock = in_stock_.data();
+    int count = recipe.slots.size();
+    int shorts = 0;
+
+    //Gathering and comparing every entry without an early exit; vectorized with VECFLAGS (AVX2 gathers)
+#pragma GCC ivdep
+    for (int j = 0; j < count; j++) {
+        int slot = slots[j];
+        shorts += (in_stock[slot] == 0) | (quantities[slot] - reserved[slot] < needs[j]);
+    }
+
+    return shorts;
+}
+
+/**
+* Deducts servings of a compiled recipe from the stock.
+* @param recipe The compiled recipe of an assigned dish; its slots are
+distinct.
+* @param servings The number of servings, which the unreserved stock
+covers.
+* @post: Every entry is deducted and depleted slots leave the stock.
+*/
+void KitchenStation::deduct(const CompiledRecipe& recipe, int servings) {
+    const int* __restrict slots = recipe.slots.data();
+    const int* __restrict needs = recipe.needs.data();
+    int* __restrict quantities = stock_quantities_.data();
+    int count = recipe.slots.size();
+
+    //Scattering the deduction; the slots are distinct, so no two entries write the same quantity. Only targets with scatters (AVX-512) vectorize it
+#pragma GCC ivdep
+    for (int j = 0; j < count; j++)
+        quantities[slots[j]] -= needs[j] * servings;
+
+    for (int j = 0; j < count; j++) {
+        int slot = slots[j];
+
+        //Remove the ingredient from the stock if the quantity is 0
+        if (quantities[slot] == 0) {
+            in_stock_[slot] = false;
+            metrics_.add(Metrics::STOCK_OUTS);
+        }
+    }
+}
+
+/**
+* Gives a reservation's ingredients back to the stock.
+* @param handle The reservation, which must be held.
+* @post: The reservation is forgotten and servings_ is current.
+*/
+void KitchenStation::dropReservation(ReservationHandle handle) {
+    auto found = reservations_.find(handle);
+    const Reservation& reservation = found->second;
+
+    for (size_t j = 0; j < reservation.slots.size(); j++)
+        reserved_[reservation.slots[j]] -= reservation.amounts[j];
+
+    for (size_t j = 0; j < reservation.slots.size(); j++)
+        refreshServings(reservation.slots[j]);
+
+    reservations_.erase(found);
+}
+
+/**
+* Releases the reservations whose ttl has run out. The caller holds the
+station's lock exclusively.
+* @return: The number of reservations released.
+*/
+int KitchenStation::reclaimExpired() {
+    std::vector<unsigned long> due;
+    reservation_timers_.advance(reservationTick(), due);
+
+    //Committed and released reservations are still on the wheel and are skipped here
+    int expired = 0;
+    for (size_t i = 0; i < due.size(); i++) {
+        if (reservations_.count(due[i]) > 0) {
+            dropReservation(due[i]);
+            expired++;
+        }
+    }
+
+    //Committed and released reservations do not lower it, so the next check may find nothing due, which only costs a recount
+    long long next_expiry = LLONG_MAX;
+    for (auto it = reservations_.begin(); it != reservations_.end(); ++it)
+        next_expiry = std::min(next_expiry, it->second.deadline);
+    next_expiry_.store(next_expiry);
+
+    return expired;
+}
+
+/**
+* Releases expired reservations from a path that would otherwise only
+share the lock, if the earliest deadline has passed and the lock can be
+taken exclusively without waiting. The caller holds no lock.
+*/
+void KitchenStation::reclaimIfDue() {
+    if (reservationTick() < next_expiry_.load(std::memory_order_relaxed))
+        return;
+
+    //Never waiting here; whoever holds the lock, or the next check, reclaims instead
+    std::unique_lock<std::shared_mutex> lock(station_mutex_, std::try_to_lock);
+    if (!lock.owns_lock())
+        return;
+
+    if (concurrent_stock_)
+        pullCounters();
+
+    reclaimExpired();
+
+    if (concurrent_stock_)
+        pushCounters();
+}
+
+/**
+* Retrieves the current time on the reservation timers' scale.
+* @return: The steady clock in RESERVATION_TICK units.
+*/
+long long KitchenStation::reservationTick() {
+    return std::chrono::steady_clock::now().time_since_epoch() / RESERVATION_TICK;
+}
+
+/**
+* Recounts the servings of the dishes that use a stock slot after it
+changed.
+* @param slot The stock slot whose quantity or entry changed.
+* @post: servings_ is current for those dishes.
+*/
+void KitchenStation::refreshServings(int slot) {
+    for (size_t d = 0; d < slot_users_[slot].size(); d++) {
+        int dish = slot_users_[slot][d];
+        setServings(dish, computeServings(recipes_[dish]));
+    }
+}
+
+/**
+* Records a dish's servings remaining.
+* @param dish The dish's index in dishes_.
+* @param servings The servings the stock can still make.
+* @post: A changed dish is queued for takeServingsChanges, and the
+listener is called if the dish became (un)available.
+*/
+void KitchenStation::setServings(int dish, int servings) {
+    int previous = servings_[dish];
+    if (previous == servings)
+        return;
+
+    servings_[dish] = servings;
+
+    if (!servings_dirty_[dish]) {
+        servings_dirty_[dish] = true;
+        changed_dishes_.push_back(dish);
+    }
+
+    if ((previous > 0) != (servings > 0) && availability_listener_)
+        availability_listener_(this, dish_ids_[dish], servings > 0);
+}
+
+/**
+* Counts a failed order check against every ingredient of a dish that
+falls short. The caller holds the station's lock, shared or exclusive.
+* @param dish The dish's index in dishes_.
+*/
+void KitchenStation::reportMissing(int dish) {
+    const CompiledRecipe& recipe = recipes_[dish];
+
+    for (size_t j = 0; j < recipe.slots.size(); j++) {
+        int slot = recipe.slots[j];
+        int available = 0;
+
+        if (in_stock_[slot])
+            available = concurrent_stock_ ? counters_[slot].quantity.load(std::memory_order_relaxed) : unreserved(slot);
+
+        if (available < recipe.needs[j])
+            metrics_.addMissing(stock_names_[slot]);
+    }
+}
+
+/**
+* Reports a preparation to the metrics and the stock listener, if any.
+The caller holds the station's lock.
+* @param dish The dish's index in dishes_.
+* @param servings The servings prepared.
+*/
+void KitchenStation::reportPrepared(int dish, int servings) {
+    metrics_.add(Metrics::ORDERS_PREPARED);
+    metrics_.add(Metrics::SERVINGS_PREPARED, servings);
+
+    if (!stock_listener_)
+        return;
+
+    //The name is only copied out of the dish when someone listens
+    std::string dish_name = dishes_[dish]->getName();
+    StockEvent event;
+    event.type = StockEvent::PREPARED;
+    event.dish_name = &dish_name;
+    event.servings = servings;
+    stock_listener_(this, event);
+}
+
+/**
+* Prepares a dish from the atomic counters. The caller holds the
+station's lock, shared or exclusive.
+* @param dish The dish's index in dishes_, or -1 if not assigned.
+* @post: Either every ingredient is claimed or every claim is given
+back. A slot the order dropped below what some dish needs is queued
+for recountCrossed.
+* @return: The outcome, as tryPrepare.
+*/
+KitchenStation::PrepareResult KitchenStation::prepareFromCounters(int dish) {
+    PrepareResult result;
+
+    if (dish == -1)
+        return result;
+
+    result.dish_assigned = true;
+    const CompiledRecipe& recipe = recipes_[dish];
+
+    //A dish without ingredients cannot be ordered
+    if (recipe.slots.size() == 0)
+        return result;
+
+    //Claiming ingredients in slot order until one falls short
+    size_t claimed = 0;
+    for (; claimed < recipe.slots.size(); claimed++) {
+        int slot = recipe.slots[claimed];
+        int need = recipe.needs[claimed];
+        std::atomic<int>& quantity = counters_[slot].quantity;
+        int available = in_stock_[slot] ? quantity.load(std::memory_order_relaxed) : 0;
+
+        //A failed compare_exchange reloads available, so the loop retries with the current quantity
+        while (in_stock_[slot] && need > 0 && available >= need
+            && !quantity.compare_exchange_weak(available, available - need, std::memory_order_acq_rel, std::memory_order_relaxed)) {
+        }
+
+        if (!in_stock_[slot] || available < need) {
+            result.shortfalls.push_back(Shortfall{stock_names_[slot], need, available});
+            break;
+        }
+
+        if (need > 0 && crossesThreshold(slot, available, available - need))
+            queueRecount(slot);
+    }
+
+    if (result.shortfalls.empty()) {
+        result.prepared = true;
+        reportPrepared(dish, 1);
+        return result;
+    }
+
+    //Giving back what was claimed before the shortfall
+    for (size_t j = claimed; j-- > 0;)
+        counters_[recipe.slots[j]].quantity.fetch_add(recipe.needs[j], std::memory_order_acq_rel);
+
+    //Checking the rest only for the report
+    for (size_t j = claimed + 1; j < recipe.slots.size(); j++) {
+        int slot = recipe.slots[j];
+        int available = in_stock_[slot] ? counters_[slot].quantity.load(std::memory_order_relaxed) : 0;
+
+        if (!in_stock_[slot] || available < recipe.needs[j])
+            result.shortfalls.push_back(Shortfall{stock_names_[slot], recipe.needs[j], available});
+    }
+
+    return result;
+}
+
+/**
+* Queues a stock slot for recountCrossed, unless already queued.
+* @param slot The stock slot that fell below a threshold.
+*/
+void KitchenStation::queueRecount(int slot) {
+    if (counters_[slot].recount.exchange(true, std::memory_order_acq_rel))
+        return;
+
+    std::lock_guard<std::mutex> lock(recount_queue_mutex_);
+    recount_slots_.push_back(slot);
+    recount_pending_.store(true);
+}
+
+/**
+* Recounts, from the atomic counters, the servings of the dishes that
+use a queued slot. The caller holds the station's lock, shared or
+exclusive. If another order is already recounting, this returns at
+once and that order picks up the queued slots.
+* @post: servings_ is current for the dishes of every slot queued
+before the call, unless another order is recounting them.
+*/
+void KitchenStation::recountCrossed() {
+    //The recounting order checks the queue again after unlocking, so a slot queued while it ran is not left behind
+    while (recount_pending_.load() && recount_mutex_.try_lock()) {
+        std::vector<int> slots;
+        {
+            std::lock_guard<std::mutex> lock(recount_queue_mutex_);
+            slots.swap(recount_slots_);
+            recount_pending_.store(false);
+        }
+
+        //Clearing the flags first, so a slot crossed again during the recount is queued again
+        for (size_t i = 0; i < slots.size(); i++)
+            counters_[slots[i]].recount.store(false, std::memory_order_release);
+
+        for (size_t i = 0; i < slots.size(); i++) {
+            const std::vector<int>& users = slot_users_[slots[i]];
+            for (size_t j = 0; j < users.size(); j++)
+                setServings(users[j], counterServings(recipes_[users[j]]));
+        }
+
+        recount_mutex_.unlock();
+    }
+}
+
+/**
+* Counts the servings a compiled recipe can still make from the atomic
+counters.
+* @param recipe The compiled recipe of an assigned dish.
+* @return: As computeServings, from a snapshot of the counters.
+*/
+int KitchenStation::counterServings(const CompiledRecipe& recipe) const {
+    //A dish without ingredients cannot be ordered
+    if (recipe.slots.size() == 0)
+        return 0;
+
+    int servings = INT_MAX;
+    for (size_t j = 0; j < recipe.slots.size(); j++) {
+        int slot = recipe.slots[j];
+
+        if (!in_stock_[slot])
+            return 0;
+
+        if (recipe.needs[j] > 0)
+            servings = std::min(servings, counters_[slot].quantity.load(std::memory_order_relaxed) / recipe.needs[j]);
+    }
+
+    return std::max(servings, 0);
+}
+
+/**
+* Checks whether a slot's quantity fell below the need of a dish that
+uses it.
+* @param slot The stock slot.
+* @param before The quantity before the deduction.
+* @param after The quantity after the deduction.
+* @return: True if some need n has after < n <= before.
+*/
+bool KitchenStation::crossesThreshold(int slot, int before, int after) const {
+    const std::vector<int>& thresholds = slot_thresholds_[slot];
+    auto above = std::upper_bound(thresholds.begin(), thresholds.end(), after);
+
+    return above != thresholds.end() && *above <= before;
+}
+
+/**
+* Copies the stock into the atomic counters. The caller holds the
+station's lock exclusively.
+* @post: counters_ has one entry per stock slot and slot_thresholds_
+matches the compiled recipes.
+*/
+void KitchenStation::pushCounters() {
+    if (counter_count_ != stock_names_.size()) {
+        counters_.reset(new StockCounter[stock_names_.size()]);
+        counter_count_ = stock_names_.size();
+    }
+
+    for (size_t i = 0; i < counter_count_; i++) {
+        counters_[i].quantity.store(unreserved(i), std::memory_order_relaxed);
+        counters_[i].recount.store(false, std::memory_order_relaxed);
+    }
+    recount_slots_.clear();
+    recount_pending_.store(false);
+
+    //Collecting the needs each slot can drop below
+    slot_thresholds_.assign(stock_names_.size(), std::vector<int>());
+    for (size_t d = 0; d < recipes_.size(); d++) {
+        for (size_t j = 0; j < recipes_[d].slots.size(); j++) {
+            if (recipes_[d].needs[j] > 0)
+                slot_thresholds_[recipes_[d].slots[j]].push_back(recipes_[d].needs[j]);
+        }
+    }
+
+    for (size_t i = 0; i < slot_thresholds_.size(); i++) {
+        std::vector<int>& thresholds = slot_thresholds_[i];
+        std::sort(thresholds.begin(), thresholds.end());
+        thresholds.erase(std::unique(thresholds.begin(), thresholds.end()), thresholds.end());
+    }
+}
+
+/**
+* Copies the atomic counters back into the stock. The caller holds the
+station's lock exclusively.
+* @post: Depleted ingredients are removed from the stock and servings_
+is recounted, notifying the listener of every flip.
+*/
+void KitchenStation::pullCounters() {
+    for (size_t i = 0; i < counter_count_ && i < stock_names_.size(); i++) {
+        if (!in_stock_[i])
+            continue;
+
+        stock_quantities_[i] = counters_[i].quantity.load(std::memory_order_relaxed) + reserved_[i];
+
+        //Remove the ingredient from the stock if the quantity is 0; only orders deplete the counters
+        if (stock_quantities_[i] == 0) {
+            in_stock_[i] = false;
+            metrics_.add(Metrics::STOCK_OUTS);
+        }
+    }
+
+    for (size_t d = 0; d < recipes_.size(); d++)
+        setServings(d, computeServings(recipes_[d]));
+
+    //Every dish was recounted, so nothing queued is left to do
+    for (size_t i = 0; i < counter_count_; i++)
+        counters_[i].recount.store(false, std::memory_order_relaxed);
+    recount_slots_.clear();
+    recount_pending_.store(false);
 }
 
 // void KitchenStation::setIngredient(const std::vector<Ingredient> i) {
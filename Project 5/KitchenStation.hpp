@@ -8,12 +8,99 @@
 #define KITCHENSTATION_HPP
 
 #include "Dish.hpp"
+#include "TimerWheel.hpp"
+#include "RecipeCatalog.hpp"
+#include "Metrics.hpp"
 #include <string>
 #include <vector>
 #include <iostream>
+#include <unordered_map>
+#include <utility>
+#include <mutex>
+#include <shared_mutex>
+#include <atomic>
+#include <memory>
+#include <chrono>
+#include <functional>
+#include <climits>
 
 class KitchenStation {
     public:
+        /**
+        * An ingredient an order could not get enough of.
+        */
+        struct Shortfall {
+            std::string ingredient; //name of the ingredient
+            int needed; //quantity the order needs
+            int available; //quantity in stock (0 if not in stock)
+        };
+
+        /**
+        * Outcome of tryPrepare.
+        */
+        struct PrepareResult {
+            bool prepared = false; //true if the stock was deducted
+            bool dish_assigned = false; //false if the station has no such dish
+            std::vector<Shortfall> shortfalls; //every ingredient that fell short
+        };
+
+        /**
+        * What a forecast of orders would leave of the stock, one array per
+        field as in the stock itself; entry k is the station's stock slot k.
+        */
+        struct StockForecast {
+            std::vector<std::string> ingredients; //ingredient name of each slot
+            std::vector<int> balances; //unreserved quantity left after the forecast; negative if it falls short
+            std::vector<int> required; //required_quantity of each slot
+            std::vector<double> prices; //price per unit of each slot
+        };
+
+        /**
+        * Called with (station, dish id, can complete now) whenever a dish's
+        canCompleteOrder answer at the station flips. It runs while the
+        station is locked (shared in the concurrent stock mode, but never
+        from two threads at once), so it must not call back into the station.
+        */
+        typedef std::function<void(KitchenStation*, RecipeCatalog::DishId, bool)> AvailabilityListener;
+
+        /**
+        * A change the station made to its own dishes or stock. Only the
+        fields of the event's type are set.
+        */
+        struct StockEvent {
+            enum Type { ASSIGNED, REPLENISHED, PREPARED };
+            Type type;
+            const Dish* dish = nullptr; //ASSIGNED: the dish assigned
+            const Ingredient* ingredient = nullptr; //REPLENISHED: the ingredient added
+            const std::string* dish_name = nullptr; //PREPARED: the dish prepared
+            int servings = 0; //PREPARED: the servings prepared
+        };
+
+        /**
+        * Called with (station, event) after every assignDishToStation,
+        replenishStationIngredients and successful preparation, in the order
+        the station applied them. It runs while the station is locked (shared
+        in the concurrent stock mode, so possibly from several threads at
+        once), so it must not call back into the station. Merges are not
+        reported.
+        */
+        typedef std::function<void(KitchenStation*, const StockEvent&)> StockListener;
+
+        /**
+        * Called with (station, new name) by setName before the name changes,
+        so whoever indexes the station by name can follow it. Returning
+        false refuses the new name.
+        */
+        typedef std::function<bool(KitchenStation*, const std::string&)> RenameListener;
+
+        /**
+        * Identifies a reservation made by reserve; 0 is never a valid handle.
+        */
+        typedef unsigned long ReservationHandle;
+
+        //How long a reservation holds its ingredients unless told otherwise
+        static constexpr std::chrono::milliseconds DEFAULT_RESERVATION_TTL{30000};
+
         /**
         * Default Constructor
         * @post: Initializes an empty kitchen station with default values.
@@ -29,13 +116,14 @@ class KitchenStation {
 
         /**
         * Destructor
-        * @post: Deallocates all dynamically allocated dishes in the
-        station.
+        * @post: Releases the station's references to its recipes; a
+        recipe no other station refers to is deallocated.
         */
         ~KitchenStation();
 
         /**
-        * Retrieves the name of the kitchen station.
+        * Retrieves the name of the kitchen station. Safe to call from any
+        thread, including while the station is being renamed.
         * @return: The name of the station.
         */
         std::string getName() const;
@@ -43,15 +131,31 @@ class KitchenStation {
         /**
         * Sets the name of the kitchen station.
         * @param name A string representing the new station name.
-        * @post: Updates the station's name.
+        * @post: Updates the station's name, unless the rename listener
+        refuses it (a manager refuses a name another of its stations has).
+        * @return: True if the name was updated; false otherwise.
         */
-        void setName(const std::string& name);
+        bool setName(const std::string& name);
 
         /**
         * Retrieves the list of dishes assigned to the kitchen station.
-        * @return A vector of pointers to Dish objects assigned to the station.
+        * @return A vector of pointers to the immutable, possibly shared Dish
+        objects assigned to the station. They stay valid while the station
+        keeps the dish.
+        */
+        std::vector<const Dish*> getDishes() const;
+
+        /**
+        * Retrieves the catalog id of each dish assigned to the station.
+        * @return: The ids, in the order of getDishes.
         */
-        std::vector<Dish*> getDishes() const;
+        std::vector<RecipeCatalog::RecipeId> getRecipeIds() const;
+
+        /**
+        * Retrieves the dish id of each dish assigned to the station.
+        * @return: The ids, in the order of getDishes.
+        */
+        std::vector<RecipeCatalog::DishId> getDishIds() const;
 
         /**
         * Retrieves the ingredient stock available at the kitchen station.
@@ -62,14 +166,28 @@ class KitchenStation {
 
         /**
         * Assigns a dish to the station.
-        * @param dish A pointer to a Dish object.
-        * @post: Adds the dish to the station's list of dishes if not
-        already present.
+        * @param dish A pointer to a dynamically allocated Dish object.
+        * @post: If no dish of that name is present, the station takes
+        ownership of dish through the recipe catalog (an identical recipe
+        already in the catalog is shared, and dish is kept until the station
+        lets go of it), and compiles its recipe against the station's stock
+        slots. The same Dish may be
+        assigned to several stations. Otherwise dish is left to the caller.
         * @return: True if the dish was added successfully; false
         otherwise.
         */
         bool assignDishToStation(Dish* dish);
 
+        /**
+        * Assigns a recipe already in the catalog to the station.
+        * @param id The recipe's catalog id.
+        * @post: Adds the recipe to the station's list of dishes if it is
+        still in the catalog and no dish of that name is present.
+        * @return: True if the dish was added successfully; false
+        otherwise.
+        */
+        bool assignRecipe(RecipeCatalog::RecipeId id);
+
         /**
         * Replenishes the station's ingredient stock.
         * @param ingredient An Ingredient object.
@@ -82,10 +200,52 @@ class KitchenStation {
         * Checks if the station can complete an order for a specific dish.
         * @param dish_name A string representing the name of the dish.
         * @return: True if the station has the dish assigned and all
-        required ingredients are in stock; false otherwise.
+        required ingredients are in stock, not counting reserved quantities;
+        false otherwise.
         */
         bool canCompleteOrder(const std::string& dish_name);
 
+        /**
+        * Checks if the station can complete an order for a specific dish.
+        * @param dish_id The dish's id in the recipe catalog.
+        * @return: As canCompleteOrder by name, without comparing strings.
+        */
+        bool canCompleteOrder(RecipeCatalog::DishId dish_id);
+
+        /**
+        * Checks many orders against the station under one lock.
+        * @param dish_names The names of the dishes.
+        * @return: Entry i is canCompleteOrder(dish_names[i]), all answered
+        against the same stock.
+        */
+        std::vector<bool> canCompleteOrders(const std::vector<std::string>& dish_names);
+
+        /**
+        * Checks many orders against the station under one lock.
+        * @param dish_ids The dishes' ids in the recipe catalog.
+        * @return: Entry i is canCompleteOrder(dish_ids[i]), all answered
+        against the same stock.
+        */
+        std::vector<bool> canCompleteOrders(const std::vector<RecipeCatalog::DishId>& dish_ids);
+
+        /**
+        * Checks if the station can complete an order for a specific dish,
+        for routing scans that ask every station: the check is neither timed
+        nor counted in the station's metrics.
+        * @param dish_id The dish's id in the recipe catalog.
+        * @return: As canCompleteOrder.
+        */
+        bool isAvailable(RecipeCatalog::DishId dish_id);
+
+        /**
+        * Checks many orders against the station under one lock, uncounted
+        like isAvailable.
+        * @param dish_ids The dishes' ids in the recipe catalog.
+        * @return: Entry i is isAvailable(dish_ids[i]), all answered against
+        the same stock.
+        */
+        std::vector<bool> areAvailable(const std::vector<RecipeCatalog::DishId>& dish_ids);
+
         /**
         * Prepares a dish if possible.
         * @param dish_name A string representing the name of the dish.
@@ -97,6 +257,192 @@ class KitchenStation {
         */
         bool prepareDish(const std::string& dish_name); 
 
+        /**
+        * Prepares a dish if possible.
+        * @param dish_id The dish's id in the recipe catalog.
+        * @post: As prepareDish by name.
+        * @return: True if the dish was prepared successfully; false
+        otherwise.
+        */
+        bool prepareDish(RecipeCatalog::DishId dish_id);
+
+        /**
+        * Prepares a dish if possible, checking and deducting the stock in
+        one pass while holding the station's lock.
+        * @param dish_name A string representing the name of the dish.
+        * @post: Either every ingredient of the dish is deducted (depleted
+        ingredients are removed from the stock) or the stock is left exactly
+        as it was; no other caller can observe a partial deduction.
+        * @return: The outcome, listing every ingredient that fell short when
+        the dish could not be prepared.
+        */
+        PrepareResult tryPrepare(const std::string& dish_name);
+
+        /**
+        * Prepares a dish if possible, checking and deducting the stock in
+        one pass while holding the station's lock.
+        * @param dish_id The dish's id in the recipe catalog.
+        * @return: As tryPrepare by name.
+        */
+        PrepareResult tryPrepare(RecipeCatalog::DishId dish_id);
+
+        /**
+        * Prepares a burst of orders at once.
+        * @param orders (dish name, servings) pairs.
+        * @post: The total demand of every ingredient is added up and
+        checked against the stock once. If everything fits, every order is
+        prepared; otherwise orders are filled in the given sequence with as
+        many servings as the remaining stock allows. The stock is deducted
+        once per ingredient and depleted ingredients are removed.
+        * @return: The number of servings prepared for each order, in the same
+        sequence as orders (0 for unassigned dishes).
+        */
+        std::vector<int> prepareBatch(const std::vector<std::pair<std::string, int>>& orders);
+
+        /**
+        * Moves the dishes and ingredient stock of another station into
+        this station.
+        * @param other The station being merged into this one.
+        * @post: Dishes not already assigned here are transferred (ownership
+        included) and ingredient quantities are added to the stock. Dishes
+        already present stay in other, which is left with no stock. Other's
+        reservations are released, not moved: what they held becomes free
+        stock here and their handles are no longer held by either station.
+        */
+        void absorb(KitchenStation&& other);
+
+        /**
+        * Sets the callback told about availability changes.
+        * @param listener The callback, or nullptr to stop notifications.
+        * @post: Every later flip of a dish's canCompleteOrder answer caused by
+        assigning, replenishing, preparing or absorbing is reported.
+        */
+        void setAvailabilityListener(AvailabilityListener listener);
+
+        /**
+        * Sets the callback told about changes to the dishes and stock.
+        * @param listener The callback, or nullptr to stop notifications.
+        */
+        void setStockListener(StockListener listener);
+
+        /**
+        * Sets the callback asked before every rename.
+        * @param listener The callback, or nullptr to rename freely.
+        */
+        void setRenameListener(RenameListener listener);
+
+        /**
+        * Holds the ingredients of some servings of a dish for an order that
+        will be cooked later (two-phase preparation).
+        * @param dish_name A string representing the name of the dish.
+        * @param servings The number of servings to hold.
+        * @param ttl How long the hold lasts before it is released on its own.
+        * @post: The ingredients stay in the stock but no other order can use
+        them until the reservation is committed, released or expires.
+        * @return: A handle for commit/release; 0 if the dish is not assigned,
+        servings is not positive, or the unreserved stock is short.
+        */
+        ReservationHandle reserve(const std::string& dish_name, int servings, std::chrono::milliseconds ttl = DEFAULT_RESERVATION_TTL);
+
+        /**
+        * Cooks a reservation.
+        * @param handle A handle returned by reserve.
+        * @post: The held ingredients are deducted as if the servings were
+        prepared (depleted ingredients are removed from the stock).
+        * @return: True if the reservation was still held; false if it was
+        already committed, released or expired.
+        */
+        bool commit(ReservationHandle handle);
+
+        /**
+        * Gives up a reservation.
+        * @param handle A handle returned by reserve.
+        * @post: The held ingredients are available to other orders again.
+        * @return: True if the reservation was still held; false otherwise.
+        */
+        bool release(ReservationHandle handle);
+
+        /**
+        * Releases every reservation whose ttl has run out. Reserving,
+        committing, releasing and preparing in the locked stock mode also do
+        this, and checks and concurrent-mode orders do it when the earliest
+        deadline has passed and the lock is free, so callers only need it to
+        reclaim stock on an idle station.
+        * @return: The number of reservations released.
+        */
+        int expireReservations();
+
+        /**
+        * Retrieves how many more servings of a dish the station can make.
+        * @param dish_name A string representing the name of the dish.
+        * @return: The servings remaining, not counting reserved quantities; 0
+        if the dish is not assigned.
+        */
+        int servingsRemaining(const std::string& dish_name) const;
+
+        /**
+        * Retrieves the prep time of an assigned dish.
+        * @param dish_name A string representing the name of the dish.
+        * @return: The dish's prep time; -1 if the dish is not assigned.
+        */
+        int getPrepTime(const std::string& dish_name) const;
+
+        /**
+        * Retrieves the servings remaining of every assigned dish.
+        * @return: (dish name, servings remaining) pairs in assignment order.
+        */
+        std::vector<std::pair<std::string, int>> getServingsBoard() const;
+
+        /**
+        * Works out what forecast servings of the station's dishes would
+        leave of the stock, without deducting anything.
+        * @param demand Servings forecast for each dish, indexed by dish id.
+        * @post: The entries of the station's dishes in demand are set to 0,
+        so stations planned afterwards do not plan for them again.
+        * @return: The balance of every stock slot, including slots that are
+        out of stock.
+        */
+        StockForecast forecastStock(std::vector<int>& demand) const;
+
+        /**
+        * Retrieves the dishes whose servings remaining changed since the last
+        call, so an availability board can be refreshed with work
+        proportional to what changed.
+        * @post: The set of changed dishes is emptied.
+        * @return: (dish name, servings remaining) pairs, one per changed dish.
+        */
+        std::vector<std::pair<std::string, int>> takeServingsChanges();
+
+        /**
+        * Switches the station's stock between the locked mode and the
+        concurrent mode, where quantities are atomic counters and
+        prepareDish/tryPrepare only share the station's lock. An order claims
+        its ingredients one by one with compare-and-swap, in slot order, and
+        gives back what it claimed if one falls short, so concurrent orders
+        never oversell and never wait on each other.
+        * @param enabled True to turn the concurrent mode on; false to fold the
+        counters back into the stock.
+        * @post: While enabled, availability changes caused by preparing are
+        reported when an order drops an ingredient below what some dish
+        needs, and takeServingsChanges recounts the servings first. Other
+        operations take the lock exclusively and keep their usual behavior.
+        */
+        void setConcurrentStock(bool enabled);
+
+        /**
+        * Checks whether the concurrent stock mode is on.
+        * @return: True if quantities are kept in atomic counters.
+        */
+        bool concurrentStock() const;
+
+        /**
+        * Retrieves the station's operation counters and latency histograms.
+        * Recording never takes the station's lock: every thread adds to its
+        own shard.
+        * @return: The station's metrics.
+        */
+        const Metrics& metrics() const;
+
         // void setIngredient(const std::vector<Ingredient> i);
 
         // std::vector<Ingredient> getIngredient();
@@ -106,9 +452,334 @@ class KitchenStation {
         // std::vector<Dish*> getDish();
         
     private:
+        /**
+        * A dish's ingredient list resolved to stock slots. Entry j needs
+        needs[j] units of slot slots[j], i.e. uses[j] times the slot's
+        required_quantity.
+        */
+        struct CompiledRecipe {
+            std::vector<int> slots;
+            std::vector<int> uses;
+            std::vector<int> needs;
+        };
+
+        /**
+        * The quantity of one stock slot in the concurrent mode, on its own
+        cache line so orders using different ingredients do not contend.
+        */
+        struct alignas(64) StockCounter {
+            std::atomic<int> quantity{0};
+            std::atomic<bool> recount{false}; //whether the slot is queued in recount_slots_
+        };
+
+        //Resolution of reservation expiry; one turn of the timer wheel spans 51.2s
+        static constexpr std::chrono::milliseconds RESERVATION_TICK{100};
+        static const int RESERVATION_WHEEL_SLOTS = 512;
+
+        /**
+        * Ingredients held by reserve. Entry j holds amounts[j] units of slot
+        slots[j].
+        */
+        struct Reservation {
+            int dish;
+            int servings;
+            std::vector<int> slots;
+            std::vector<int> amounts;
+            long long deadline; //reservation tick at which it expires
+        };
+
         std::string station_name_; //representing the station’s name
-        std::vector<Dish*> dishes_; //storing pointers to dishes that the station can prepare
-        std::vector<Ingredient> ingredients_stock_; //representing the ingredients available at the station
+        std::vector<std::shared_ptr<const Dish>> dishes_; //storing the catalog's recipes of dishes that the station can prepare
+        std::vector<RecipeCatalog::RecipeId> recipe_ids_; //catalog id of each dish, parallel to dishes_
+        //The stock, one array per field so checks gather only what they compare; a slot keeps its index for the station's lifetime
+        std::vector<std::string> stock_names_; //ingredient name of each slot
+        std::vector<int> stock_quantities_; //quantity of each slot
+        std::vector<int> stock_required_; //required_quantity per use of each slot
+        std::vector<double> stock_prices_; //price of each slot
+        std::vector<int> in_stock_; //1 while each slot is part of the stock, 0 once depleted; int-sized so checks gather it like the quantities
+        std::vector<int> reserved_; //quantity of each slot held by reservations; counted in the slot's quantity
+        std::unordered_map<std::string, int> stock_slots_; //ingredient name -> slot in the stock arrays
+        std::vector<CompiledRecipe> recipes_; //compiled recipe of each dish, parallel to dishes_
+        std::unordered_map<std::string, int> dish_index_; //dish name -> index in dishes_
+        std::vector<RecipeCatalog::DishId> dish_ids_; //catalog dish id of each dish, parallel to dishes_
+        std::vector<int> dish_by_id_; //catalog dish id -> index in dishes_, -1 if not assigned; sized to the largest id assigned
+        std::vector<std::vector<int>> slot_users_; //stock slot -> indices of the dishes whose recipe uses it
+        std::vector<int> servings_; //servings remaining of each dish from unreserved stock, parallel to dishes_; kept current through slot_users_
+        std::vector<bool> servings_dirty_; //whether each dish is in changed_dishes_
+        std::vector<int> changed_dishes_; //dishes whose servings changed since takeServingsChanges
+        AvailabilityListener availability_listener_; //told when an entry of servings_ crosses zero
+        StockListener stock_listener_; //told about every assignment, replenishment and preparation
+        RenameListener rename_listener_; //asked before every rename
+        std::atomic<bool> concurrent_stock_{false}; //whether counters_ holds the quantities; changed only under the exclusive lock
+        std::unique_ptr<StockCounter[]> counters_; //quantity of each stock slot in the concurrent mode
+        size_t counter_count_ = 0; //number of entries in counters_
+        std::vector<std::vector<int>> slot_thresholds_; //stock slot -> sorted distinct needs of the dishes using it
+        std::vector<int> recount_slots_; //slots an order dropped below a threshold, whose users are not yet recounted
+        std::atomic<bool> recount_pending_{false}; //whether recount_slots_ may be non-empty
+        std::mutex recount_queue_mutex_; //guards recount_slots_
+        std::mutex recount_mutex_; //held by the one order recounting servings_ in the concurrent mode
+        std::unordered_map<ReservationHandle, Reservation> reservations_; //reservations still held
+        TimerWheel reservation_timers_{RESERVATION_WHEEL_SLOTS}; //expiry of each reservation, in RESERVATION_TICK units
+        ReservationHandle next_reservation_ = 1; //handle of the next reservation
+        std::atomic<long long> next_expiry_{LLONG_MAX}; //no reservation expires before this tick; LLONG_MAX if none is held
+        mutable std::shared_mutex station_mutex_; //guards the dishes and stock of the station; shared by concurrent-mode orders
+        mutable std::mutex name_mutex_; //guards station_name_ alone, so listeners called under station_mutex_ can still read the name
+        Metrics metrics_; //operation counts and latency; sharded per thread, so not guarded
+
+        /**
+        * Assigns a recipe without taking the station's lock.
+        * @param recipe A recipe from the catalog.
+        * @return: True if the dish was added; false if already present.
+        */
+        bool addDish(const RecipeCatalog::Recipe& recipe);
+
+        /**
+        * Replenishes the stock without taking the station's lock.
+        * @param ingredient An Ingredient object.
+        */
+        void restock(const Ingredient& ingredient);
+
+        /**
+        * Looks up an ingredient that is currently in stock.
+        * @param ingredient_name A string representing the ingredient's name.
+        * @return: The ingredient's slot if it is in stock; -1 otherwise.
+        */
+        int findStockSlot(const std::string& ingredient_name) const;
+
+        /**
+        * Looks up an assigned dish.
+        * @param dish_name A string representing the name of the dish.
+        * @return: The dish's index in dishes_ if assigned; -1 otherwise.
+        */
+        int findDish(const std::string& dish_name) const;
+
+        /**
+        * Looks up an assigned dish by id.
+        * @param dish_id The dish's id in the recipe catalog.
+        * @return: The dish's index in dishes_ if assigned; -1 otherwise.
+        */
+        int findDish(RecipeCatalog::DishId dish_id) const;
+
+        /**
+        * Checks an assigned dish. The caller holds the station's lock,
+        shared or exclusive.
+        * @param dish The dish's index in dishes_, or -1 if not assigned.
+        * @param counted Whether a failed check is counted in the metrics.
+        * @return: As canCompleteOrder.
+        */
+        bool checkDish(int dish, bool counted);
+
+        /**
+        * Checks many assigned dishes against one view of the stock. The
+        caller holds the station's lock, shared or exclusive.
+        * @param dishes Indices in dishes_; -1 for dishes not assigned.
+        * @param counted Whether failed checks are counted in the metrics.
+        * @return: Entry i is checkDish(dishes[i], counted).
+        */
+        std::vector<bool> checkDishes(const std::vector<int>& dishes, bool counted);
+
+        /**
+        * Prepares a dish under the station's lock, in whichever stock mode
+        is on when the lock is taken.
+        * @param dish_name The name of the dish, or nullptr to look it up by
+        dish_id instead.
+        * @param dish_id The dish's id in the recipe catalog; used only if
+        dish_name is nullptr.
+        * @return: The outcome, as tryPrepare.
+        */
+        PrepareResult prepareLocked(const std::string* dish_name, RecipeCatalog::DishId dish_id);
+
+        /**
+        * Returns the stock slot of an ingredient, creating an empty one if
+        the ingredient was never stocked.
+        * @param ingredient_name A string representing the ingredient's name.
+        * @param required_quantity The required_quantity of a new slot.
+        * @param price The price of a new slot until it is stocked.
+        * @return: The ingredient's slot; a new slot starts out of stock.
+        */
+        int bindStockSlot(const std::string& ingredient_name, int required_quantity, double price);
+
+        /**
+        * Compiles a dish's ingredient list into stock slots.
+        * @param dish The dish to compile.
+        * @param dish_index The dish's index in dishes_.
+        * @post: Every ingredient is bound to a stock slot and the dish is
+        registered as a user of those slots.
+        * @return: The compiled recipe, with repeated ingredients combined.
+        */
+        CompiledRecipe compileRecipe(const Dish& dish, int dish_index);
+
+        /**
+        * Recomputes the required quantities that depend on a stock slot.
+        * @param slot The stock slot whose entry was replaced.
+        * @post: Every compiled recipe using slot needs the slot's current
+        required_quantity per use.
+        */
+        void refreshNeeds(int slot);
+
+        /**
+        * Counts the servings a compiled recipe can still make from the stock.
+        * @param recipe The compiled recipe of an assigned dish.
+        * @return: The minimum over the recipe of quantity / needed quantity;
+        0 if the recipe is empty or uses an ingredient that is out of stock.
+        */
+        int computeServings(const CompiledRecipe& recipe) const;
+
+        /**
+        * Retrieves the quantity of a stock slot that orders can use.
+        * @param slot The stock slot.
+        * @return: The quantity not held by reservations; 0 if the slot is out
+        of stock.
+        */
+        int unreserved(int slot) const;
+
+        /**
+        * Counts the entries of a compiled recipe the unreserved stock cannot
+        cover.
+        * @param recipe The compiled recipe of an assigned dish.
+        * @return: The number of entries whose slot is out of stock or holds
+        less than the entry needs; 0 if one serving can be made.
+        */
+        int countShort(const CompiledRecipe& recipe) const;
+
+        /**
+        * Deducts servings of a compiled recipe from the stock.
+        * @param recipe The compiled recipe of an assigned dish; its slots are
+        distinct.
+        * @param servings The number of servings, which the unreserved stock
+        covers.
+        * @post: Every entry is deducted and depleted slots leave the stock.
+        */
+        void deduct(const CompiledRecipe& recipe, int servings);
+
+        /**
+        * Gives a reservation's ingredients back to the stock.
+        * @param handle The reservation, which must be held.
+        * @post: The reservation is forgotten and servings_ is current.
+        */
+        void dropReservation(ReservationHandle handle);
+
+        /**
+        * Releases the reservations whose ttl has run out. The caller holds the
+        station's lock exclusively.
+        * @return: The number of reservations released.
+        */
+        int reclaimExpired();
+
+        /**
+        * Releases expired reservations from a path that would otherwise only
+        share the lock, if the earliest deadline has passed and the lock can
+        be taken exclusively without waiting. The caller holds no lock.
+        */
+        void reclaimIfDue();
+
+        /**
+        * Retrieves the current time on the reservation timers' scale.
+        * @return: The steady clock in RESERVATION_TICK units.
+        */
+        static long long reservationTick();
+
+        /**
+        * Recounts the servings of the dishes that use a stock slot after it
+        changed.
+        * @param slot The stock slot whose quantity or entry changed.
+        * @post: servings_ is current for those dishes.
+        */
+        void refreshServings(int slot);
+
+        /**
+        * Records a dish's servings remaining.
+        * @param dish The dish's index in dishes_.
+        * @param servings The servings the stock can still make.
+        * @post: A changed dish is queued for takeServingsChanges, and the
+        listener is called if the dish became (un)available.
+        */
+        void setServings(int dish, int servings);
+
+        /**
+        * Counts a failed order check against every ingredient of a dish that
+        falls short. The caller holds the station's lock, shared or
+        exclusive.
+        * @param dish The dish's index in dishes_.
+        */
+        void reportMissing(int dish);
+
+        /**
+        * Reports a preparation to the metrics and the stock listener, if
+        any. The caller holds the station's lock.
+        * @param dish The dish's index in dishes_.
+        * @param servings The servings prepared.
+        */
+        void reportPrepared(int dish, int servings);
+
+        /**
+        * Prepares a dish from the atomic counters. The caller holds the
+        station's lock, shared or exclusive.
+        * @param dish The dish's index in dishes_, or -1 if not assigned.
+        * @post: Either every ingredient is claimed or every claim is given
+        back. A slot the order dropped below what some dish needs is queued
+        for recountCrossed.
+        * @return: The outcome, as tryPrepare.
+        */
+        PrepareResult prepareFromCounters(int dish);
+
+        /**
+        * Queues a stock slot for recountCrossed, unless already queued.
+        * @param slot The stock slot that fell below a threshold.
+        */
+        void queueRecount(int slot);
+
+        /**
+        * Recounts, from the atomic counters, the servings of the dishes that
+        use a queued slot. The caller holds the station's lock, shared or
+        exclusive. If another order is already recounting, this returns at
+        once and that order picks up the queued slots.
+        * @post: servings_ is current for the dishes of every slot queued
+        before the call, unless another order is recounting them.
+        */
+        void recountCrossed();
+
+        /**
+        * Prepares a dish from the stock arrays. The caller holds the
+        station's lock exclusively.
+        * @param dish The dish's index in dishes_, or -1 if not assigned.
+        * @return: The outcome, as tryPrepare.
+        */
+        PrepareResult prepareFromStock(int dish);
+
+        /**
+        * Counts the servings a compiled recipe can still make from the atomic
+        counters.
+        * @param recipe The compiled recipe of an assigned dish.
+        * @return: As computeServings, from a snapshot of the counters.
+        */
+        int counterServings(const CompiledRecipe& recipe) const;
+
+        /**
+        * Checks whether a slot's quantity fell below the need of a dish that
+        uses it.
+        * @param slot The stock slot.
+        * @param before The quantity before the deduction.
+        * @param after The quantity after the deduction.
+        * @return: True if some need n has after < n <= before.
+        */
+        bool crossesThreshold(int slot, int before, int after) const;
+
+        /**
+        * Copies the stock into the atomic counters. The caller holds the
+        station's lock exclusively.
+        * @post: counters_ has one entry per stock slot and slot_thresholds_
+        matches the compiled recipes.
+        */
+        void pushCounters();
+
+        /**
+        * Copies the atomic counters back into the stock. The caller holds the
+        station's lock exclusively.
+        * @post: Depleted ingredients are removed from the stock and servings_
+        is recounted, notifying the listener of every flip.
+        */
+        void pullCounters();
 };
 
 #endif // KITCHENSTATION_HPP
\ No newline at end of file
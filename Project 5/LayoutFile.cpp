@@ -0,0 +1,178 @@
+/**
+ * @brief This file contains the implementation of the LayoutFile class, which reads and writes the comma-separated station and stock files of a virtual bistro simulation.
+*/
+
+#include "LayoutFile.hpp"
+#include <charconv>
+#include <cstdio>
+#include <cstring>
+
+/**
+* Streams the records of a comma-separated file, one line at a time.
+* @param path The file to read.
+* @param record Called with the fields of each line, in order; returning
+false stops the read.
+* @return: True if the whole file was read; false if it could not be
+opened or read, or record returned false.
+*/
+bool LayoutFile::readRecords(const std::string& path, const std::function<bool(const Fields&)>& record) {
+    std::FILE* file = std::fopen(path.c_str(), "rb");
+
+    if (file == nullptr)
+        return false;
+
+    std::vector<char> buffer(CHUNK_BYTES);
+    Fields fields;
+    size_t filled = 0;
+    bool ok = true;
+    bool at_end = false;
+
+    while (ok && !at_end) {
+        //Making room when a single line outgrows the buffer
+        if (filled == buffer.size())
+            buffer.resize(buffer.size() * 2);
+
+        size_t wanted = buffer.size() - filled;
+        size_t read = std::fread(buffer.data() + filled, 1, wanted, file);
+
+        //A short read is either the end of the file or an error, and an error must not pass for the end
+        if (read < wanted && std::ferror(file)) {
+            ok = false;
+            break;
+        }
+
+        filled += read;
+        at_end = read == 0;
+
+        //Handing over every complete line; at the end of the file the last line needs no newline
+        size_t start = 0;
+        while (ok) {
+            const char* newline = static_cast<const char*>(std::memchr(buffer.data() + start, '\n', filled - start));
+            size_t end = (newline != nullptr) ? newline - buffer.data() : filled;
+
+            if (newline == nullptr && (!at_end || start == filled))
+                break;
+
+            std::string_view line(buffer.data() + start, end - start);
+            start = (newline != nullptr) ? end + 1 : filled;
+
+            if (!line.empty() && line.back() == '\r')
+                line.remove_suffix(1);
+            if (line.empty() || line[0] == '#')
+                continue;
+
+            fields.clear();
+            size_t field_start = 0;
+            size_t comma;
+            while ((comma = line.find(',', field_start)) != std::string_view::npos) {
+                fields.push_back(line.substr(field_start, comma - field_start));
+                field_start = comma + 1;
+            }
+            fields.push_back(line.substr(field_start));
+
+            ok = record(fields);
+        }
+
+        //Keeping the partial line for the next chunk
+        std::memmove(buffer.data(), buffer.data() + start, filled - start);
+        filled -= start;
+    }
+
+    std::fclose(file);
+    return ok;
+}
+
+/**
+* Parses a whole field as an integer.
+* @param field The field.
+* @param value Receives the integer.
+* @return: True if the field is exactly one integer; false otherwise.
+*/
+bool LayoutFile::toInt(std::string_view field, int& value) {
+    const char* end = field.data() + field.size();
+    std::from_chars_result result = std::from_chars(field.data(), end, value);
+
+    return result.ec == std::errc() && result.ptr == end;
+}
+
+/**
+* Parses a whole field as a double.
+* @param field The field.
+* @param value Receives the double.
+* @return: True if the field is exactly one number; false otherwise.
+*/
+bool LayoutFile::toDouble(std::string_view field, double& value) {
+    const char* end = field.data() + field.size();
+    std::from_chars_result result = std::from_chars(field.data(), end, value);
+
+    return result.ec == std::errc() && result.ptr == end;
+}
+
+/**
+* Parses a cuisine written by Dish::getCuisineType.
+* @param field The field, e.g. "ITALIAN".
+* @param cuisine Receives the cuisine.
+* @return: True if the field names a cuisine; false otherwise.
+*/
+bool LayoutFile::toCuisine(std::string_view field, Dish::CuisineType& cuisine) {
+    static const char* names[] = {"ITALIAN", "MEXICAN", "CHINESE", "INDIAN", "AMERICAN", "FRENCH", "OTHER"};
+    static const Dish::CuisineType cuisines[] = {Dish::ITALIAN, Dish::MEXICAN, Dish::CHINESE, Dish::INDIAN, Dish::AMERICAN, Dish::FRENCH, Dish::OTHER};
+
+    for (int i = 0; i < 7; i++) {
+        if (field == names[i]) {
+            cuisine = cuisines[i];
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+* Checks whether a name can be written as one field.
+* @param value The name.
+* @return: True if it is not empty, has no comma or line break and does
+not start with '#'; false otherwise.
+*/
+bool LayoutFile::isWritable(const std::string& value) {
+    return !value.empty() && value[0] != '#' && value.find_first_of(",\r\n") == std::string::npos;
+}
+
+/**
+* Appends a field to a line being written.
+* @param line The line so far.
+* @param value The field.
+*/
+void LayoutFile::putField(std::string& line, const std::string& value) {
+    if (!line.empty())
+        line += ',';
+    line += value;
+}
+
+/**
+* Appends an integer field.
+* @param line The line so far.
+* @param value The integer.
+*/
+void LayoutFile::putField(std::string& line, int value) {
+    char digits[16];
+    std::to_chars_result result = std::to_chars(digits, digits + sizeof(digits), value);
+
+    if (!line.empty())
+        line += ',';
+    line.append(digits, result.ptr);
+}
+
+/**
+* Appends a double field, written so that it reads back exactly.
+* @param line The line so far.
+* @param value The double.
+*/
+void LayoutFile::putField(std::string& line, double value) {
+    char digits[32];
+    std::to_chars_result result = std::to_chars(digits, digits + sizeof(digits), value);
+
+    if (!line.empty())
+        line += ',';
+    line.append(digits, result.ptr);
+}
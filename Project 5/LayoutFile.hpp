@@ -0,0 +1,90 @@
+/**
+ * @brief This file contains the declaration of the LayoutFile class, which reads and writes the comma-separated station and stock files of a virtual bistro simulation.
+*/
+
+#ifndef LAYOUTFILE_HPP
+#define LAYOUTFILE_HPP
+
+#include "Dish.hpp"
+#include <string>
+#include <string_view>
+#include <vector>
+#include <functional>
+
+class LayoutFile {
+    public:
+        //The fields of one line; they point into the reader's buffer and are only valid during the callback
+        typedef std::vector<std::string_view> Fields;
+
+        /**
+        * Streams the records of a comma-separated file, one line at a time,
+        without reading the whole file into memory.
+        * @param path The file to read.
+        * @param record Called with the fields of each line, in order. Empty
+        lines and lines starting with '#' are skipped, and a trailing '\r'
+        is dropped. Returning false stops the read.
+        * @return: True if the whole file was read; false if it could not be
+        opened or read, or record returned false.
+        */
+        static bool readRecords(const std::string& path, const std::function<bool(const Fields&)>& record);
+
+        /**
+        * Parses a whole field as an integer.
+        * @param field The field.
+        * @param value Receives the integer.
+        * @return: True if the field is exactly one integer; false otherwise.
+        */
+        static bool toInt(std::string_view field, int& value);
+
+        /**
+        * Parses a whole field as a double.
+        * @param field The field.
+        * @param value Receives the double.
+        * @return: True if the field is exactly one number; false otherwise.
+        */
+        static bool toDouble(std::string_view field, double& value);
+
+        /**
+        * Parses a cuisine written by Dish::getCuisineType.
+        * @param field The field, e.g. "ITALIAN".
+        * @param cuisine Receives the cuisine.
+        * @return: True if the field names a cuisine; false otherwise.
+        */
+        static bool toCuisine(std::string_view field, Dish::CuisineType& cuisine);
+
+        /**
+        * Checks whether a name can be written as one field.
+        * @param value The name.
+        * @return: True if it is not empty, has no comma or line break and
+        does not start with '#'; false otherwise.
+        */
+        static bool isWritable(const std::string& value);
+
+        /**
+        * Appends a field to a line being written, preceded by a comma unless
+        the line is empty.
+        * @param line The line so far.
+        * @param value The field.
+        */
+        static void putField(std::string& line, const std::string& value);
+
+        /**
+        * Appends an integer field.
+        * @param line The line so far.
+        * @param value The integer.
+        */
+        static void putField(std::string& line, int value);
+
+        /**
+        * Appends a double field, written so that it reads back exactly.
+        * @param line The line so far.
+        * @param value The double.
+        */
+        static void putField(std::string& line, double value);
+
+    private:
+        //How much of the file is read at a time
+        static const int CHUNK_BYTES = 64 * 1024;
+};
+
+#endif // LAYOUTFILE_HPP
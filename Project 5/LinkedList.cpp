@@ -13,17 +13,18 @@
 
 #include "LinkedList.hpp"  // Header file
 #include <cassert>
+#include <utility>
 
 // constructor
-template<class T>
-LinkedList<T>::LinkedList() : head_ptr_(nullptr), item_count_(0)
+template<class T, class Allocator>
+LinkedList<T, Allocator>::LinkedList() : head_ptr_(nullptr), tail_ptr_(nullptr), item_count_(0)
 {
 }  // end default constructor
 
 
 // copy constructor
-template<class T>
-LinkedList<T>::LinkedList(const LinkedList<T>& a_list) : item_count_(a_list.item_count_)
+template<class T, class Allocator>
+LinkedList<T, Allocator>::LinkedList(const LinkedList<T, Allocator>& a_list) : tail_ptr_(nullptr), item_count_(a_list.item_count_)
 {
    Node<T>* orig_chain_pointer = a_list.head_ptr_;  // Points to nodes in original chain
 
@@ -31,9 +32,11 @@ LinkedList<T>::LinkedList(const LinkedList<T>& a_list) : item_count_(a_list.item
       head_ptr_ = nullptr;  // Original list is empty
    else
    {
+      // Take every node of the copy from one contiguous block
+      node_pool_.reserve(item_count_);
+
       // Copy first node
-      head_ptr_ = new Node<T>();
-      head_ptr_->setItem(orig_chain_pointer->getItem());
+      head_ptr_ = node_pool_.allocate(orig_chain_pointer->getItem());
 
       // Copy remaining nodes
       Node<T>* new_chain_ptr = head_ptr_;      // Points to last node in new chain
@@ -44,7 +47,7 @@ LinkedList<T>::LinkedList(const LinkedList<T>& a_list) : item_count_(a_list.item
          T next_item = orig_chain_pointer->getItem();
 
          // Create a new node containing the next item
-         Node<T>* new_node_ptr = new Node<T>(next_item);
+         Node<T>* new_node_ptr = node_pool_.allocate(next_item);
 
          // Link new node to end of new chain
          new_chain_ptr->setNext(new_node_ptr);
@@ -57,30 +60,65 @@ LinkedList<T>::LinkedList(const LinkedList<T>& a_list) : item_count_(a_list.item
       }  // end while
 
       new_chain_ptr->setNext(nullptr);              // Flag end of chain
+      tail_ptr_ = new_chain_ptr;
    }  // end if
 }  // end copy constructor
 
 
+// move constructor
+template<class T, class Allocator>
+LinkedList<T, Allocator>::LinkedList(LinkedList<T, Allocator>&& a_list) noexcept
+   : head_ptr_(a_list.head_ptr_), tail_ptr_(a_list.tail_ptr_), item_count_(a_list.item_count_), node_pool_(std::move(a_list.node_pool_))
+{
+   a_list.head_ptr_ = nullptr;
+   a_list.tail_ptr_ = nullptr;
+   a_list.item_count_ = 0;
+}  // end move constructor
+
+
 // destructor
-template<class T>
-LinkedList<T>::~LinkedList()
+template<class T, class Allocator>
+LinkedList<T, Allocator>::~LinkedList()
 {
    clear();
 }  // end destructor
 
 
 
+/**@post this list holds a_list's chain and a_list is empty
+   @return *this */
+template<class T, class Allocator>
+LinkedList<T, Allocator>& LinkedList<T, Allocator>::operator=(LinkedList<T, Allocator>&& a_list) noexcept
+{
+   if (this != &a_list)
+   {
+      clear();
+      head_ptr_ = a_list.head_ptr_;
+      tail_ptr_ = a_list.tail_ptr_;
+      item_count_ = a_list.item_count_;
+      node_pool_ = std::move(a_list.node_pool_);
+
+      a_list.head_ptr_ = nullptr;
+      a_list.tail_ptr_ = nullptr;
+      a_list.item_count_ = 0;
+   }  // end if
+
+   return *this;
+}  // end move assignment
+
+
+
 /**@return true if list is empty - item_count_ == 0 */
-template<class T>
-bool LinkedList<T>::isEmpty() const
+template<class T, class Allocator>
+bool LinkedList<T, Allocator>::isEmpty() const
 {
    return item_count_ == 0;
 }  // end isEmpty
 
 
 /**@return the number of items in the list - item_count_ */
-template<class T>
-int LinkedList<T>::getLength() const
+template<class T, class Allocator>
+int LinkedList<T, Allocator>::getLength() const
 {
    return item_count_;
 }  // end getLength
@@ -93,33 +131,17 @@ int LinkedList<T>::getLength() const
  @param new_entry to be inserted in list
  @post new_entry is added at position in list (the node previously at that position is now at position+1)
  @return true if valid position (0 <= position <= item_count_) */
-template<class T>
-bool LinkedList<T>::insert(int positions, const T& new_entry)
+template<class T, class Allocator>
+bool LinkedList<T, Allocator>::insert(int positions, const T& new_entry)
 {
    bool able_to_insert = (positions >= 0) && (positions <= item_count_ );
    if (able_to_insert)
    {
       // Create a new node containing the new entry
-      Node<T>* new_node_ptr = new Node<T>(new_entry);
+      Node<T>* new_node_ptr = node_pool_.allocate(new_entry);
 
-      // Attach new node to chain
-      if (positions == 0)
-      {
-         // Insert new node at beginning of chain
-         new_node_ptr->setNext(head_ptr_);
-         head_ptr_ = new_node_ptr;
-      }
-      else
-      {
-         // Find node that will be before new node
-         Node<T>* prev_ptr = getNodeAt(positions - 1);
-
-         // Insert new node after node to which prev_ptr points
-         new_node_ptr->setNext(prev_ptr->getNext());
-         prev_ptr->setNext(new_node_ptr);
-      }  // end if
-
-      item_count_++;  // Increase count of entries
+      // Attach new node to chain after the node that will be before it
+      spliceAfter(positions == 0 ? nullptr : getNodeAt(positions - 1), new_node_ptr);
    }  // end if
 
    return able_to_insert;
@@ -132,38 +154,14 @@ bool LinkedList<T>::insert(int positions, const T& new_entry)
  @param position indicating point of deletion
  @post node at position is deleted, if any. List order is retains
  @return true if there is a node at position to be deleted, false otherwise */
-template<class T>
-bool LinkedList<T>::remove(int position)
+template<class T, class Allocator>
+bool LinkedList<T, Allocator>::remove(int position)
 {
    bool able_to_remove = (position >= 0) && (position < item_count_);
    if (able_to_remove)
    {
-      Node<T>* cur_ptr = nullptr;
-      if (position == 0)
-      {
-         // Remove the first node in the chain
-         cur_ptr = head_ptr_; // Save pointer to node
-         head_ptr_ = head_ptr_->getNext();
-      }
-      else
-      {
-         // Find node that is before the one to delete
-         Node<T>* prev_ptr = getNodeAt(position - 1);
-
-         // Point to node to delete
-         cur_ptr = prev_ptr->getNext();
-
-         // Disconnect indicated node from chain by connecting the
-         // prior node with the one after
-         prev_ptr->setNext(cur_ptr->getNext());
-      }  // end if
-
-      // Return node to system
-      cur_ptr->setNext(nullptr);
-      delete cur_ptr;
-      cur_ptr = nullptr;
-
-      item_count_--;  // Decrease count of entries
+      // Disconnect the node after the one before it and return it to the pool
+      removeAfter(position == 0 ? nullptr : getNodeAt(position - 1));
    }  // end if
 
    return able_to_remove;
@@ -172,11 +170,21 @@ bool LinkedList<T>::remove(int position)
 
 
 /**@post the list is empty and item_count_ == 0*/
-template<class T>
-void LinkedList<T>::clear()
+template<class T, class Allocator>
+void LinkedList<T, Allocator>::clear()
 {
-   while (!isEmpty())
-      remove(0);
+   // Walk the chain once, handing every node back to the pool
+   Node<T>* cur_ptr = head_ptr_;
+   while (cur_ptr != nullptr)
+   {
+      Node<T>* next_ptr = cur_ptr->getNext();
+      node_pool_.deallocate(cur_ptr);
+      cur_ptr = next_ptr;
+   }  // end while
+
+   head_ptr_ = nullptr;
+   tail_ptr_ = nullptr;
+   item_count_ = 0;
 }  // end clear
 
 
@@ -186,8 +194,8 @@ void LinkedList<T>::clear()
  @param position indicating the position of the data to be retrieved
  @return data item found at position. If position is not a valid position < item_count_
  throws  PrecondViolatedExcep */
-template<class T>
-T LinkedList<T>::getEntry(int position) const
+template<class T, class Allocator>
+T LinkedList<T, Allocator>::getEntry(int position) const
 {
     // Enforce precondition
     bool ableToGet = (position >= 0) && (position < item_count_);
@@ -208,6 +216,83 @@ T LinkedList<T>::getEntry(int position) const
 
 
 
+/**
+ @pre list positions follow traditional indexing from 0 to item_count_ -1
+ @param position of the node to unlink
+ @post the node is unlinked but not freed; it must be spliced back into this list
+ @return the unlinked node, or nullptr if position is not valid */
+template<class T, class Allocator>
+Node<T>* LinkedList<T, Allocator>::extract(int position)
+{
+   if (position < 0 || position >= item_count_)
+      return nullptr;
+
+   return extractAfter(position == 0 ? nullptr : getNodeAt(position - 1));
+}  // end extract
+
+
+
+/**
+ @param position indicating point of insertion (0 <= position <= item_count_)
+ @param node_ptr a node previously extracted from this list
+ @post node_ptr is linked at position without allocating
+ @return true if valid position */
+template<class T, class Allocator>
+bool LinkedList<T, Allocator>::splice(int position, Node<T>* node_ptr)
+{
+   bool able_to_splice = (node_ptr != nullptr) && (position >= 0) && (position <= item_count_);
+   if (able_to_splice)
+      spliceAfter(position == 0 ? nullptr : getNodeAt(position - 1), node_ptr);
+
+   return able_to_splice;
+}  // end splice
+
+
+
+/**
+ @param position indicating point of insertion (0 <= position <= item_count_)
+ @param a_list another list whose nodes are moved into this list
+ @post a_list's entries are relinked at position in order, a_list is empty
+ @return true if valid position */
+template<class T, class Allocator>
+bool LinkedList<T, Allocator>::splice(int position, LinkedList<T, Allocator>& a_list)
+{
+   bool able_to_splice = (this != &a_list) && (position >= 0) && (position <= item_count_);
+   if (able_to_splice && a_list.head_ptr_ != nullptr)
+   {
+      // The nodes keep living in a_list's slabs, so this list takes them over
+      node_pool_.adopt(a_list.node_pool_);
+
+      Node<T>* last_ptr = a_list.tail_ptr_;
+      Node<T>* prev_ptr = (position == 0) ? nullptr : getNodeAt(position - 1);
+      if (prev_ptr == nullptr)
+      {
+         last_ptr->setNext(head_ptr_);
+         head_ptr_ = a_list.head_ptr_;
+      }
+      else
+      {
+         last_ptr->setNext(prev_ptr->getNext());
+         prev_ptr->setNext(a_list.head_ptr_);
+      }  // end if
+
+      // a_list's last node ends the chain if it went in at the end
+      if (prev_ptr == tail_ptr_)
+         tail_ptr_ = last_ptr;
+
+      item_count_ += a_list.item_count_;
+      a_list.head_ptr_ = nullptr;
+      a_list.tail_ptr_ = nullptr;
+      a_list.item_count_ = 0;
+   }  // end if
+
+   return able_to_splice;
+}  // end splice
+
+
+
+
+
 /************* PROTECTED METHODS ************/
 
 
@@ -216,9 +301,13 @@ T LinkedList<T>::getEntry(int position) const
 // @param position the index of the desired node
 //       0 <= position < item_count_
 // @return  A pointer to the node at the given position or nullptr if position is >= item_count_
-template<class T>
-Node<T>* LinkedList<T>::getNodeAt(int position) const
+template<class T, class Allocator>
+Node<T>* LinkedList<T, Allocator>::getNodeAt(int position) const
 {
+    // The last node is known without a walk
+    if (position == item_count_ - 1)
+        return tail_ptr_;
+
     // Count from the beginning of the chain
     Node<T>* cur_ptr = head_ptr_;
     for (int skip = 0; skip < position; skip++)
@@ -227,10 +316,76 @@ Node<T>* LinkedList<T>::getNodeAt(int position) const
     return cur_ptr;
 }  // end getNodeAt
 
+// Links a new node holding new_entry directly after prev_ptr.
+// @param prev_ptr the node to insert after, or nullptr to insert at the head
+// @param new_entry to be inserted in list
+// @return  A pointer to the newly linked node
+template<class T, class Allocator>
+Node<T>* LinkedList<T, Allocator>::insertAfter(Node<T>* prev_ptr, const T& new_entry)
+{
+    Node<T>* new_node_ptr = node_pool_.allocate(new_entry);
+    spliceAfter(prev_ptr, new_node_ptr);
+    return new_node_ptr;
+}  // end insertAfter
+
+// Unlinks and deletes the node directly after prev_ptr.
+// @pre prev_ptr is nullptr (meaning the head node) or a node of this list with a successor
+// @param prev_ptr the node preceding the one to delete, or nullptr for the head
+template<class T, class Allocator>
+void LinkedList<T, Allocator>::removeAfter(Node<T>* prev_ptr)
+{
+    node_pool_.deallocate(extractAfter(prev_ptr));
+}  // end removeAfter
+
+// Unlinks the node directly after prev_ptr without freeing it.
+// @pre prev_ptr is nullptr (meaning the head node) or a node of this list with a successor
+// @return  A pointer to the unlinked node
+template<class T, class Allocator>
+Node<T>* LinkedList<T, Allocator>::extractAfter(Node<T>* prev_ptr)
+{
+    Node<T>* cur_ptr = (prev_ptr == nullptr) ? head_ptr_ : prev_ptr->getNext();
+    assert(cur_ptr != nullptr);
+
+    if (prev_ptr == nullptr)
+        head_ptr_ = cur_ptr->getNext();
+    else
+        prev_ptr->setNext(cur_ptr->getNext());
+
+    if (cur_ptr == tail_ptr_)
+        tail_ptr_ = prev_ptr;
+
+    cur_ptr->setNext(nullptr);
+    item_count_--;
+    return cur_ptr;
+}  // end extractAfter
+
+// Links an unlinked node directly after prev_ptr.
+// @param prev_ptr the node to link after, or nullptr to link at the head
+// @param node_ptr a node previously extracted from this list
+template<class T, class Allocator>
+void LinkedList<T, Allocator>::spliceAfter(Node<T>* prev_ptr, Node<T>* node_ptr)
+{
+    if (prev_ptr == nullptr)
+    {
+        node_ptr->setNext(head_ptr_);
+        head_ptr_ = node_ptr;
+    }
+    else
+    {
+        node_ptr->setNext(prev_ptr->getNext());
+        prev_ptr->setNext(node_ptr);
+    }  // end if
+
+    if (prev_ptr == tail_ptr_)
+        tail_ptr_ = node_ptr;
+
+    item_count_++;
+}  // end spliceAfter
+
 //position follows classic indexing from 0 to item_count_-1
 //if position > item_count it returns nullptr
-template <class T>
-Node<T> *LinkedList<T>::getPointerTo(size_t position) const
+template<class T, class Allocator>
+Node<T> *LinkedList<T, Allocator>::getPointerTo(size_t position) const
 {
 
   Node<T> *find = nullptr;
@@ -250,12 +405,22 @@ Node<T> *LinkedList<T>::getPointerTo(size_t position) const
 
 
 //returns the head pointer
-template <class T>
-Node<T> *LinkedList<T>::getHeadNode() const
+template<class T, class Allocator>
+Node<T> *LinkedList<T, Allocator>::getHeadNode() const
 {
 
   return head_ptr_;
 } //end getHeadNode
 
 
+
+//returns the last node, or nullptr if the list is empty
+template<class T, class Allocator>
+Node<T> *LinkedList<T, Allocator>::getTailNode() const
+{
+
+  return tail_ptr_;
+} //end getTailNode
+
+
 //  End of implementation file.
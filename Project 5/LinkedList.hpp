@@ -14,17 +14,25 @@
 #define LINKED_LIST_
 
 #include "Node.hpp"
+#include "NodePool.hpp"
 #include "PrecondViolatedExcep.hpp"
 
-template<class T>
+// Allocator supplies allocate(item), deallocate(node) and reserve(count);
+// NewNodeAllocator<T> restores one new/delete per node
+template<class T, class Allocator = NodePool<T>>
 class LinkedList
 {
 
 public:
    LinkedList(); // constructor
-   LinkedList(const LinkedList<T>& a_list); // copy constructor
+   LinkedList(const LinkedList<T, Allocator>& a_list); // copy constructor, nodes come from one block
+   LinkedList(LinkedList<T, Allocator>&& a_list) noexcept; // move constructor, steals the chain
    virtual ~LinkedList(); // destructor
 
+   /**@post this list holds a_list's chain and a_list is empty
+      @return *this */
+   LinkedList<T, Allocator>& operator=(LinkedList<T, Allocator>&& a_list) noexcept;
+
    /**@return true if list is empty - item_count_ == 0 */
    bool isEmpty() const;
 
@@ -61,11 +69,36 @@ public:
             throws  PrecondViolatedExcep */
    T getEntry(int position) const;
 
+    /**
+     @pre list positions follow traditional indexing from 0 to item_count_ -1
+     @param position of the node to unlink
+     @post the node is unlinked but not freed; it must be spliced back into this list
+     @return the unlinked node, or nullptr if position is not valid */
+   Node<T>* extract(int position);
+
+    /**
+     @param position indicating point of insertion (0 <= position <= item_count_)
+     @param node_ptr a node previously extracted from this list
+     @post node_ptr is linked at position without allocating
+     @return true if valid position */
+   bool splice(int position, Node<T>* node_ptr);
+
+    /**
+     @param position indicating point of insertion (0 <= position <= item_count_)
+     @param a_list another list whose nodes are moved into this list
+     @post a_list's entries are relinked at position in order, a_list is empty;
+           O(1) at position 0 or item_count_, O(position) elsewhere
+     @return true if valid position */
+   bool splice(int position, LinkedList<T, Allocator>& a_list);
+
         //if position > item_count_ returns nullptr
     Node<T> *getPointerTo(size_t position) const;
 
     Node<T> *getHeadNode() const;
 
+    //returns the last node, or nullptr if the list is empty
+    Node<T> *getTailNode() const;
+
 
 
 
@@ -73,7 +106,9 @@ public:
 protected:
     Node<T>* head_ptr_; // Pointer to first node in the chain;
     // (contains the first entry in the list)
+    Node<T>* tail_ptr_; // Pointer to last node in the chain, so appends and splices need no walk
     int item_count_;           // Current count of list items
+    Allocator node_pool_;      // Source of every node in the chain
 
 
 
@@ -84,6 +119,26 @@ protected:
     // @return  A pointer to the node at the given position or nullptr if position is >= item_count_
     Node<T>* getNodeAt(int position) const;
 
+    // Links a new node holding new_entry directly after prev_ptr.
+    // @param prev_ptr the node to insert after, or nullptr to insert at the head
+    // @param new_entry to be inserted in list
+    // @return  A pointer to the newly linked node
+    Node<T>* insertAfter(Node<T>* prev_ptr, const T& new_entry);
+
+    // Unlinks and deletes the node directly after prev_ptr.
+    // @pre prev_ptr is nullptr (meaning the head node) or a node of this list with a successor
+    // @param prev_ptr the node preceding the one to delete, or nullptr for the head
+    void removeAfter(Node<T>* prev_ptr);
+
+    // Unlinks the node directly after prev_ptr without freeing it.
+    // @pre prev_ptr is nullptr (meaning the head node) or a node of this list with a successor
+    // @return  A pointer to the unlinked node
+    Node<T>* extractAfter(Node<T>* prev_ptr);
+
+    // Links an unlinked node directly after prev_ptr.
+    // @param prev_ptr the node to link after, or nullptr to link at the head
+    // @param node_ptr a node previously extracted from this list
+    void spliceAfter(Node<T>* prev_ptr, Node<T>* node_ptr);
 
 
 
@@ -0,0 +1,232 @@
+/**
+ * @brief This file contains the implementation of the Metrics class, which counts operations and their latency for a kitchen station or station manager in a virtual bistro simulation.
+*/
+
+#include "Metrics.hpp"
+#include <algorithm>
+#include <map>
+#include <thread>
+
+const long long Metrics::BUCKET_BOUNDS_NS[Metrics::BUCKET_COUNT - 1] = {256, 1000, 4000, 16000, 64000, 256000, 1000000, 4000000, 16000000};
+
+/**
+* Parameterized Constructor
+* @param metrics Where the latency is recorded.
+* @param operation The operation being timed.
+*/
+Metrics::Timer::Timer(Metrics& metrics, Operation operation)
+    : metrics_(metrics), operation_(operation), start_(std::chrono::steady_clock::now()) {
+}
+
+/**
+* Destructor
+* @post: Records the time since construction.
+*/
+Metrics::Timer::~Timer() {
+    metrics_.observe(operation_, std::chrono::steady_clock::now() - start_);
+}
+
+/**
+* Default Constructor
+* @post: Every counter and histogram is 0.
+*/
+Metrics::Metrics() : shards_(new Shard[shardCount()]) {
+    for (int s = 0; s < shardCount(); s++) {
+        for (int c = 0; c < COUNTER_COUNT; c++)
+            shards_[s].counters[c].store(0, std::memory_order_relaxed);
+
+        for (int o = 0; o < OPERATION_COUNT; o++) {
+            for (int b = 0; b < BUCKET_COUNT; b++)
+                shards_[s].buckets[o][b].store(0, std::memory_order_relaxed);
+            shards_[s].latency_ns[o].store(0, std::memory_order_relaxed);
+        }
+    }
+}
+
+/**
+* Adds to a counter.
+* @param counter The counter.
+* @param amount The amount to add.
+*/
+void Metrics::add(Counter counter, long amount) {
+    localShard().counters[counter].fetch_add(amount, std::memory_order_relaxed);
+}
+
+/**
+* Counts a failed canCompleteOrder on an ingredient that fell short.
+* @param ingredient_name The missing ingredient.
+*/
+void Metrics::addMissing(const std::string& ingredient_name) {
+    Shard& shard = localShard();
+    std::lock_guard<std::mutex> lock(shard.missing_mutex);
+    shard.missing[ingredient_name]++;
+}
+
+/**
+* Records how long an operation took.
+* @param operation The operation.
+* @param elapsed Its latency.
+*/
+void Metrics::observe(Operation operation, std::chrono::nanoseconds elapsed) {
+    long long ns = elapsed.count();
+    int bucket = 0;
+
+    while (bucket < BUCKET_COUNT - 1 && ns > BUCKET_BOUNDS_NS[bucket])
+        bucket++;
+
+    Shard& shard = localShard();
+    shard.buckets[operation][bucket].fetch_add(1, std::memory_order_relaxed);
+    shard.latency_ns[operation].fetch_add(ns, std::memory_order_relaxed);
+}
+
+/**
+* Sums a counter over the shards.
+* @param counter The counter.
+* @return: Its value.
+*/
+long Metrics::total(Counter counter) const {
+    long sum = 0;
+
+    for (int s = 0; s < shardCount(); s++)
+        sum += shards_[s].counters[counter].load(std::memory_order_relaxed);
+
+    return sum;
+}
+
+/**
+* Sums the missing-ingredient counts over the shards.
+* @return: (ingredient name, failed checks) pairs, sorted by name.
+*/
+std::vector<std::pair<std::string, long>> Metrics::missing() const {
+    std::map<std::string, long> sums;
+
+    for (int s = 0; s < shardCount(); s++) {
+        std::lock_guard<std::mutex> lock(shards_[s].missing_mutex);
+        for (auto it = shards_[s].missing.begin(); it != shards_[s].missing.end(); it++)
+            sums[it->first] += it->second;
+    }
+
+    return std::vector<std::pair<std::string, long>>(sums.begin(), sums.end());
+}
+
+/**
+* Sums the latency histogram of an operation over the shards.
+* @param operation The operation.
+* @return: The histogram.
+*/
+Metrics::Histogram Metrics::latency(Operation operation) const {
+    Histogram histogram;
+    long long ns = 0;
+    histogram.buckets.assign(BUCKET_COUNT, 0);
+
+    for (int s = 0; s < shardCount(); s++) {
+        for (int b = 0; b < BUCKET_COUNT; b++)
+            histogram.buckets[b] += shards_[s].buckets[operation][b].load(std::memory_order_relaxed);
+        ns += shards_[s].latency_ns[operation].load(std::memory_order_relaxed);
+    }
+
+    for (int b = 0; b < BUCKET_COUNT; b++)
+        histogram.count += histogram.buckets[b];
+    histogram.sum_seconds = ns / 1e9;
+
+    return histogram;
+}
+
+/**
+* Retrieves the exported name of a counter.
+* @param counter The counter.
+* @return: The name, e.g. "orders_prepared_total".
+*/
+const char* Metrics::counterName(Counter counter) {
+    switch (counter) {
+        case ORDERS_PREPARED: return "orders_prepared_total";
+        case SERVINGS_PREPARED: return "servings_prepared_total";
+        case ORDERS_REJECTED: return "orders_rejected_total";
+        case ORDER_CHECKS_FAILED: return "order_checks_failed_total";
+        case STOCK_OUTS: return "stock_outs_total";
+        case REPLENISHED_UNITS: return "replenished_units_total";
+        default: return "unknown_total";
+    }
+}
+
+/**
+* Retrieves the exported description of a counter.
+* @param counter The counter.
+* @return: One line of help text.
+*/
+const char* Metrics::counterHelp(Counter counter) {
+    switch (counter) {
+        case ORDERS_PREPARED: return "Orders filled, counting a batch order or committed reservation once.";
+        case SERVINGS_PREPARED: return "Servings made by the orders filled.";
+        case ORDERS_REJECTED: return "Orders that made nothing, counting a prepare call or batch order once.";
+        case ORDER_CHECKS_FAILED: return "canCompleteOrder calls answered false.";
+        case STOCK_OUTS: return "Ingredients depleted by orders.";
+        case REPLENISHED_UNITS: return "Ingredient quantity added by replenishment.";
+        default: return "";
+    }
+}
+
+/**
+* Retrieves the exported name of an operation.
+* @param operation The operation.
+* @return: The name, e.g. "prepare".
+*/
+const char* Metrics::operationName(Operation operation) {
+    switch (operation) {
+        case PREPARE: return "prepare";
+        case PREPARE_BATCH: return "prepare_batch";
+        case CAN_COMPLETE: return "can_complete";
+        case REPLENISH: return "replenish";
+        case ASSIGN: return "assign";
+        case RESERVE: return "reserve";
+        case COMMIT: return "commit";
+        case ADD_STATION: return "add_station";
+        case REMOVE_STATION: return "remove_station";
+        case MERGE_STATIONS: return "merge_stations";
+        default: return "unknown";
+    }
+}
+
+/**
+* Escapes a label value for the Prometheus text format.
+* @param value The raw value.
+* @return: The value with backslashes, quotes and newlines escaped.
+*/
+std::string Metrics::escapeLabel(const std::string& value) {
+    std::string escaped;
+
+    for (size_t i = 0; i < value.size(); i++) {
+        if (value[i] == '\\')
+            escaped += "\\\\";
+        else if (value[i] == '"')
+            escaped += "\\\"";
+        else if (value[i] == '\n')
+            escaped += "\\n";
+        else
+            escaped += value[i];
+    }
+
+    return escaped;
+}
+
+/**
+* Retrieves the number of shards every Metrics has.
+* @return: std::thread::hardware_concurrency, or 8 if unknown.
+*/
+int Metrics::shardCount() {
+    static const int count = std::thread::hardware_concurrency() > 0 ? std::thread::hardware_concurrency() : 8;
+    return count;
+}
+
+/**
+* Retrieves the calling thread's shard. Threads are dealt shards round
+robin, so thread i shares with thread i + shardCount().
+* @return: The shard this thread writes to.
+*/
+Metrics::Shard& Metrics::localShard() {
+    //Each thread is dealt a shard once, round robin, and keeps it for every Metrics
+    static std::atomic<int> next_shard{0};
+    thread_local int shard = next_shard.fetch_add(1, std::memory_order_relaxed) % shardCount();
+
+    return shards_[shard];
+}
@@ -0,0 +1,182 @@
+/**
+ * @brief This file contains the declaration of the Metrics class, which counts operations and their latency for a kitchen station or station manager in a virtual bistro simulation.
+*/
+
+#ifndef METRICS_HPP
+#define METRICS_HPP
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <utility>
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <chrono>
+
+class Metrics {
+    public:
+        /**
+        * Monotonic counters.
+        */
+        enum Counter {
+            ORDERS_PREPARED, //orders filled (a batch order or committed reservation counts once)
+            SERVINGS_PREPARED, //servings those orders made
+            ORDERS_REJECTED, //orders that made nothing (a prepare call or a batch order)
+            ORDER_CHECKS_FAILED, //canCompleteOrder calls answered false
+            STOCK_OUTS, //ingredients depleted by orders
+            REPLENISHED_UNITS, //ingredient quantity added by replenishment
+            COUNTER_COUNT
+        };
+
+        /**
+        * Operations whose latency is recorded.
+        */
+        enum Operation {
+            PREPARE,
+            PREPARE_BATCH,
+            CAN_COMPLETE,
+            REPLENISH,
+            ASSIGN,
+            RESERVE,
+            COMMIT,
+            ADD_STATION,
+            REMOVE_STATION,
+            MERGE_STATIONS,
+            OPERATION_COUNT
+        };
+
+        /**
+        * A latency histogram summed over the shards.
+        */
+        struct Histogram {
+            std::vector<long> buckets; //observations per bucket, the last one unbounded
+            long count = 0;
+            double sum_seconds = 0;
+        };
+
+        //Upper bounds of the latency buckets: 256ns, 1us, 4us, ... 16ms, then +Inf
+        static const int BUCKET_COUNT = 10;
+        static const long long BUCKET_BOUNDS_NS[BUCKET_COUNT - 1];
+
+        /**
+        * Times an operation from construction to destruction.
+        */
+        class Timer {
+            public:
+                Timer(Metrics& metrics, Operation operation);
+                ~Timer();
+
+            private:
+                Metrics& metrics_;
+                Operation operation_;
+                std::chrono::steady_clock::time_point start_;
+        };
+
+        /**
+        * Default Constructor
+        * @post: Every counter and histogram is 0.
+        */
+        Metrics();
+
+        /**
+        * Adds to a counter.
+        * @param counter The counter.
+        * @param amount The amount to add.
+        */
+        void add(Counter counter, long amount = 1);
+
+        /**
+        * Counts a failed canCompleteOrder on an ingredient that fell short.
+        * @param ingredient_name The missing ingredient.
+        */
+        void addMissing(const std::string& ingredient_name);
+
+        /**
+        * Records how long an operation took.
+        * @param operation The operation.
+        * @param elapsed Its latency.
+        */
+        void observe(Operation operation, std::chrono::nanoseconds elapsed);
+
+        /**
+        * Sums a counter over the shards.
+        * @param counter The counter.
+        * @return: Its value.
+        */
+        long total(Counter counter) const;
+
+        /**
+        * Sums the missing-ingredient counts over the shards.
+        * @return: (ingredient name, failed checks) pairs, sorted by name.
+        */
+        std::vector<std::pair<std::string, long>> missing() const;
+
+        /**
+        * Sums the latency histogram of an operation over the shards.
+        * @param operation The operation.
+        * @return: The histogram.
+        */
+        Histogram latency(Operation operation) const;
+
+        /**
+        * Retrieves the exported name of a counter.
+        * @param counter The counter.
+        * @return: The name, e.g. "orders_prepared_total".
+        */
+        static const char* counterName(Counter counter);
+
+        /**
+        * Retrieves the exported description of a counter.
+        * @param counter The counter.
+        * @return: One line of help text.
+        */
+        static const char* counterHelp(Counter counter);
+
+        /**
+        * Retrieves the exported name of an operation.
+        * @param operation The operation.
+        * @return: The name, e.g. "prepare".
+        */
+        static const char* operationName(Operation operation);
+
+        /**
+        * Escapes a label value for the Prometheus text format.
+        * @param value The raw value.
+        * @return: The value with backslashes, quotes and newlines escaped.
+        */
+        static std::string escapeLabel(const std::string& value);
+
+    private:
+
+        /**
+        * One shard of every counter. A thread only ever writes to its own
+        shard, with relaxed atomics; readers sum all of them.
+        */
+        struct alignas(64) Shard {
+            std::atomic<long> counters[COUNTER_COUNT];
+            std::atomic<long> buckets[OPERATION_COUNT][BUCKET_COUNT];
+            std::atomic<long long> latency_ns[OPERATION_COUNT];
+            std::unordered_map<std::string, long> missing; //ingredient name -> failed checks
+            std::mutex missing_mutex; //guards missing; only contended while a reader sums it
+        };
+
+        std::unique_ptr<Shard[]> shards_;
+
+        /**
+        * Retrieves the number of shards every Metrics has: one per hardware
+        thread, so threads only share a shard when more of them run than the
+        machine has cores.
+        * @return: std::thread::hardware_concurrency, or 8 if unknown.
+        */
+        static int shardCount();
+
+        /**
+        * Retrieves the calling thread's shard. Threads are dealt shards round
+        robin, so thread i shares with thread i + shardCount().
+        * @return: The shard this thread writes to.
+        */
+        Shard& localShard();
+};
+
+#endif // METRICS_HPP
@@ -0,0 +1,62 @@
+/**
+ * @brief This file contains the implementation of the MetricsExporter class, which periodically writes metrics to a Prometheus textfile-collector file in a virtual bistro simulation.
+*/
+
+#include "MetricsExporter.hpp"
+#include "InventoryLog.hpp"
+#include <vector>
+
+/**
+* Parameterized Constructor
+* @param path The file to write.
+* @param interval How often the file is rewritten.
+* @param render Produces the file's contents.
+* @post: Starts the exporter thread, which writes the file right away
+and then once per interval.
+*/
+MetricsExporter::MetricsExporter(const std::string& path, std::chrono::milliseconds interval, std::function<std::string()> render)
+    : path_(path), interval_(interval), render_(render), stopping_(false), exporter_(&MetricsExporter::run, this) {
+}
+
+/**
+* Destructor
+* @post: Joins the exporter thread after one last write.
+*/
+MetricsExporter::~MetricsExporter() {
+    {
+        std::lock_guard<std::mutex> lock(stop_mutex_);
+        stopping_ = true;
+    }
+    stop_requested_.notify_one();
+    exporter_.join();
+
+    writeNow();
+}
+
+/**
+* Writes the file now.
+* @post: The file is replaced atomically.
+* @return: True if the file was written; false otherwise.
+*/
+bool MetricsExporter::writeNow() {
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    std::string text = render_();
+
+    return InventoryLog::writeFileAtomically(path_, std::vector<char>(text.begin(), text.end()));
+}
+
+/**
+* The exporter thread's loop.
+* @post: Writes the file every interval until stopping_ is set.
+*/
+void MetricsExporter::run() {
+    std::unique_lock<std::mutex> lock(stop_mutex_);
+
+    while (!stopping_) {
+        lock.unlock();
+        writeNow();
+        lock.lock();
+
+        stop_requested_.wait_for(lock, interval_, [this] { return stopping_; });
+    }
+}
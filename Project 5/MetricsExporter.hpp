@@ -0,0 +1,63 @@
+/**
+ * @brief This file contains the declaration of the MetricsExporter class, which periodically writes metrics to a Prometheus textfile-collector file in a virtual bistro simulation.
+*/
+
+#ifndef METRICSEXPORTER_HPP
+#define METRICSEXPORTER_HPP
+
+#include <string>
+#include <chrono>
+#include <functional>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+
+class MetricsExporter {
+    public:
+        /**
+        * Parameterized Constructor
+        * @param path The file to write, e.g. a *.prom file in node_exporter's
+        textfile directory.
+        * @param interval How often the file is rewritten.
+        * @param render Produces the file's contents; called on the exporter's
+        thread.
+        * @post: Starts the exporter thread, which writes the file right away
+        and then once per interval.
+        */
+        MetricsExporter(const std::string& path, std::chrono::milliseconds interval, std::function<std::string()> render);
+
+        /**
+        * Destructor
+        * @post: Joins the exporter thread after one last write.
+        */
+        ~MetricsExporter();
+
+        MetricsExporter(const MetricsExporter&) = delete;
+        MetricsExporter& operator=(const MetricsExporter&) = delete;
+
+        /**
+        * Writes the file now.
+        * @post: The file is replaced atomically, so a collector never reads
+        a partial file.
+        * @return: True if the file was written; false otherwise.
+        */
+        bool writeNow();
+
+    private:
+        std::string path_;
+        std::chrono::milliseconds interval_;
+        std::function<std::string()> render_;
+        std::mutex write_mutex_; //serializes writeNow between the thread and callers
+        std::mutex stop_mutex_; //guards stopping_
+        std::condition_variable stop_requested_; //signalled by the destructor
+        bool stopping_;
+        std::thread exporter_; //started last, after every other member is ready
+
+        /**
+        * The exporter thread's loop.
+        * @post: Writes the file every interval until stopping_ is set.
+        */
+        void run();
+};
+
+#endif // METRICSEXPORTER_HPP
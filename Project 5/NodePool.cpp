@@ -0,0 +1,187 @@
+/** @file NodePool.cpp
+    Node allocators for the singly linked chain. */
+
+#include "NodePool.hpp"
+#include <new>
+#include <utility>
+
+//default constructor
+template<class T>
+NodePool<T>::NodePool() : free_list_(nullptr), slab_cursor_(nullptr), slab_end_(nullptr)
+{
+} // end default constructor
+
+
+//destructor, every node handed out must already have been deallocated
+template<class T>
+NodePool<T>::~NodePool()
+{
+   for (void* slab : slabs_)
+      ::operator delete(slab);
+} // end destructor
+
+
+//move constructor
+template<class T>
+NodePool<T>::NodePool(NodePool<T>&& other) noexcept
+   : slabs_(std::move(other.slabs_)), free_list_(other.free_list_),
+     slab_cursor_(other.slab_cursor_), slab_end_(other.slab_end_)
+{
+   other.slabs_.clear();
+   other.free_list_ = nullptr;
+   other.slab_cursor_ = nullptr;
+   other.slab_end_ = nullptr;
+} // end move constructor
+
+
+//move assignment, every node of this pool must already have been deallocated
+template<class T>
+NodePool<T>& NodePool<T>::operator=(NodePool<T>&& other) noexcept
+{
+   if (this != &other)
+   {
+      for (void* slab : slabs_)
+         ::operator delete(slab);
+
+      slabs_ = std::move(other.slabs_);
+      free_list_ = other.free_list_;
+      slab_cursor_ = other.slab_cursor_;
+      slab_end_ = other.slab_end_;
+
+      other.slabs_.clear();
+      other.free_list_ = nullptr;
+      other.slab_cursor_ = nullptr;
+      other.slab_end_ = nullptr;
+   }  // end if
+
+   return *this;
+} // end move assignment
+
+
+/** @param an_item to be stored in the node
+    @return a node holding an_item whose next_ is nullptr */
+template<class T>
+Node<T>* NodePool<T>::allocate(const T& an_item)
+{
+   void* slot = nullptr;
+   if (free_list_ != nullptr)
+   {
+      // Reuse the most recently freed slot
+      slot = free_list_;
+      free_list_ = free_list_->next;
+   }
+   else
+   {
+      if (slab_cursor_ == slab_end_)
+         addSlab(SLAB_SIZE);
+      slot = slab_cursor_++;
+   }  // end if
+
+   return new (slot) Node<T>(an_item);
+} // end allocate
+
+
+/** @param node_ptr a node previously returned by allocate() of this pool
+    @post the node is destroyed and its storage is kept for reuse */
+template<class T>
+void NodePool<T>::deallocate(Node<T>* node_ptr)
+{
+   node_ptr->~Node<T>();
+   pushFree(node_ptr);
+} // end deallocate
+
+
+/** @param count the number of nodes about to be allocated
+    @post if the free list is empty, the next count calls to allocate()
+          are served from a single contiguous block */
+template<class T>
+void NodePool<T>::reserve(int count)
+{
+   if (free_list_ == nullptr && slab_end_ - slab_cursor_ < count)
+      addSlab(count);
+} // end reserve
+
+
+/** @param other the pool whose nodes are being moved into this pool's list
+    @post this pool owns other's slabs and free slots, other is empty */
+template<class T>
+void NodePool<T>::adopt(NodePool<T>& other)
+{
+   if (this == &other)
+      return;
+
+   slabs_.insert(slabs_.end(), other.slabs_.begin(), other.slabs_.end());
+   other.slabs_.clear();
+
+   // Other's unused slots are appended to this pool's free list
+   while (other.slab_cursor_ != other.slab_end_)
+      pushFree(other.slab_cursor_++);
+   while (other.free_list_ != nullptr)
+   {
+      FreeSlot* slot = other.free_list_;
+      other.free_list_ = slot->next;
+      pushFree(slot);
+   }  // end while
+
+   other.slab_cursor_ = nullptr;
+   other.slab_end_ = nullptr;
+} // end adopt
+
+
+// @post slab_cursor_ points at a fresh block of count slots
+template<class T>
+void NodePool<T>::addSlab(int count)
+{
+   static_assert(sizeof(Node<T>) >= sizeof(FreeSlot), "node too small to thread the free list");
+
+   // Slots left in the old slab are handed to the free list so they are not lost
+   while (slab_cursor_ != slab_end_)
+      pushFree(slab_cursor_++);
+
+   void* slab = ::operator new(sizeof(Node<T>) * static_cast<std::size_t>(count));
+   slabs_.push_back(slab);
+   slab_cursor_ = static_cast<Node<T>*>(slab);
+   slab_end_ = slab_cursor_ + count;
+} // end addSlab
+
+
+// @post the raw slot is at the front of the free list
+template<class T>
+void NodePool<T>::pushFree(void* slot)
+{
+   FreeSlot* free_slot = static_cast<FreeSlot*>(slot);
+   free_slot->next = free_list_;
+   free_list_ = free_slot;
+} // end pushFree
+
+
+/** @param an_item to be stored in the node
+    @return a node holding an_item, obtained with new */
+template<class T>
+Node<T>* NewNodeAllocator<T>::allocate(const T& an_item)
+{
+   return new Node<T>(an_item);
+} // end allocate
+
+
+/** @param node_ptr a node previously returned by allocate()
+    @post the node is deleted */
+template<class T>
+void NewNodeAllocator<T>::deallocate(Node<T>* node_ptr)
+{
+   delete node_ptr;
+} // end deallocate
+
+
+/** no-op, every node is a separate allocation */
+template<class T>
+void NewNodeAllocator<T>::reserve(int count)
+{
+} // end reserve
+
+
+/** no-op, nodes are not tied to an allocator instance */
+template<class T>
+void NewNodeAllocator<T>::adopt(NewNodeAllocator<T>& other)
+{
+} // end adopt
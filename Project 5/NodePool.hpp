@@ -0,0 +1,88 @@
+/** @file NodePool.hpp
+    Node allocators for the singly linked chain. NodePool hands out nodes
+    from slabs and recycles freed nodes through a free list, so inserting
+    and removing does not go through the global allocator every time.
+    NewNodeAllocator keeps the plain new/delete behavior. */
+
+#ifndef NODE_POOL_
+#define NODE_POOL_
+
+#include "Node.hpp"
+#include <cstddef>
+#include <vector>
+
+template<class T>
+class NodePool
+{
+public:
+   NodePool();  //default constructor
+   ~NodePool(); //destructor, releases every slab
+
+   //a pool owns its slabs, so it is never shared by copying
+   NodePool(const NodePool<T>& other) = delete;
+   NodePool<T>& operator=(const NodePool<T>& other) = delete;
+
+   //moving transfers every slab, so nodes handed out stay valid
+   NodePool(NodePool<T>&& other) noexcept;
+   NodePool<T>& operator=(NodePool<T>&& other) noexcept;
+
+   /** @param an_item to be stored in the node
+       @return a node holding an_item whose next_ is nullptr */
+   Node<T>* allocate(const T& an_item);
+
+   /** @param node_ptr a node previously returned by allocate() of this pool
+       @post the node is destroyed and its storage is kept for reuse */
+   void deallocate(Node<T>* node_ptr);
+
+   /** @param count the number of nodes about to be allocated
+       @post if the free list is empty, the next count calls to allocate()
+             are served from a single contiguous block */
+   void reserve(int count);
+
+   /** @param other the pool whose nodes are being moved into this pool's list
+       @post this pool owns other's slabs and free slots, other is empty */
+   void adopt(NodePool<T>& other);
+
+private:
+   static const int SLAB_SIZE = 64; // nodes per slab when the pool grows
+
+   // Free storage is threaded through the first bytes of each slot
+   struct FreeSlot
+   {
+      FreeSlot* next;
+   };
+
+   std::vector<void*> slabs_;  // every block obtained from the system
+   FreeSlot* free_list_;       // slots returned by deallocate()
+   Node<T>* slab_cursor_;      // next never-used slot of the current slab
+   Node<T>* slab_end_;         // one past the last slot of the current slab
+
+   // @post slab_cursor_ points at a fresh block of count slots
+   void addSlab(int count);
+
+   // @post the raw slot is at the front of the free list
+   void pushFree(void* slot);
+}; // end NodePool
+
+
+template<class T>
+class NewNodeAllocator
+{
+public:
+   /** @param an_item to be stored in the node
+       @return a node holding an_item, obtained with new */
+   Node<T>* allocate(const T& an_item);
+
+   /** @param node_ptr a node previously returned by allocate()
+       @post the node is deleted */
+   void deallocate(Node<T>* node_ptr);
+
+   /** no-op, every node is a separate allocation */
+   void reserve(int count);
+
+   /** no-op, nodes are not tied to an allocator instance */
+   void adopt(NewNodeAllocator<T>& other);
+}; // end NewNodeAllocator
+
+#include "NodePool.cpp"
+#endif
@@ -0,0 +1,197 @@
+/**
+ * @brief This file contains the implementation of the OrderDispatcher class, which balances orders across station workers in a virtual bistro simulation.
+*/
+
+#include "OrderDispatcher.hpp"
+#include "StationWorker.hpp"
+#include <algorithm>
+#include <cmath>
+
+/**
+* Registers a worker as a peer that can steal and be stolen from.
+* @param worker A pointer to a running StationWorker.
+*/
+void OrderDispatcher::addWorker(StationWorker* worker) {
+    std::unique_lock<std::shared_mutex> lock(workers_mutex_);
+    workers_.push_back(worker);
+}
+
+/**
+* Unregisters a worker.
+* @param worker A pointer to a registered StationWorker.
+* @post: No steal involving the worker is in progress or can start.
+*/
+void OrderDispatcher::removeWorker(StationWorker* worker) {
+    {
+        std::lock_guard<std::mutex> lock(idle_mutex_);
+        idle_.erase(std::remove(idle_.begin(), idle_.end(), worker), idle_.end());
+    }
+
+    std::unique_lock<std::shared_mutex> lock(workers_mutex_);
+    workers_.erase(std::remove(workers_.begin(), workers_.end(), worker), workers_.end());
+}
+
+/**
+* Moves a queued order from the busiest peer that has one the
+thief's station can complete into the thief's queue.
+* @param thief The idle worker looking for work.
+* @return: True if an order was moved; false otherwise.
+*/
+bool OrderDispatcher::stealFor(StationWorker& thief) {
+    std::shared_lock<std::shared_mutex> lock(workers_mutex_);
+    std::vector<std::pair<int, StationWorker*>> victims;
+
+    //Only peers with a backlog are worth robbing
+    for (size_t i = 0; i < workers_.size(); i++) {
+        int queued = workers_[i]->queuedOrders();
+
+        if (workers_[i] != &thief && queued > 0)
+            victims.push_back(std::make_pair(queued, workers_[i]));
+    }
+
+    //Busiest first
+    std::sort(victims.begin(), victims.end(),
+              [](const std::pair<int, StationWorker*>& a, const std::pair<int, StationWorker*>& b) { return a.first > b.first; });
+
+    for (size_t i = 0; i < victims.size(); i++) {
+        if (victims[i].second->handOver(thief)) {
+            //Busy again, so the next backlog wakes a thief that is still idle
+            std::lock_guard<std::mutex> idle_lock(idle_mutex_);
+            idle_.erase(std::remove(idle_.begin(), idle_.end(), &thief), idle_.end());
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+* Tells the dispatcher an order was queued at a worker.
+* @param worker The registered worker the order was queued at.
+* @param queued The worker's queue length after the order was added.
+* @post: The worker is no longer idle. If it now has a backlog, one idle
+peer is woken to try to steal it.
+*/
+void OrderDispatcher::orderQueued(StationWorker* worker, int queued) {
+    std::lock_guard<std::mutex> lock(idle_mutex_);
+    idle_.erase(std::remove(idle_.begin(), idle_.end(), worker), idle_.end());
+
+    //The worker takes its first order itself; only a second one is worth stealing
+    if (queued < 2 || idle_.empty())
+        return;
+
+    //One thief per queued order, so a burst wakes as many thieves as it has orders to spare
+    StationWorker* thief = idle_.back();
+    idle_.pop_back();
+    thief->wakeToSteal();
+}
+
+/**
+* Marks a worker as idle, so that the next backlog can wake it.
+* @param worker A registered worker with nothing to do.
+*/
+void OrderDispatcher::markIdle(StationWorker* worker) {
+    std::lock_guard<std::mutex> lock(idle_mutex_);
+
+    if (std::find(idle_.begin(), idle_.end(), worker) == idle_.end())
+        idle_.push_back(worker);
+}
+
+/**
+* Records a finished order.
+* @param latency_us The order's latency in microseconds.
+* @param stolen True if the order was stolen from another worker.
+*/
+void OrderDispatcher::recordOrder(double latency_us, bool stolen) {
+    long long ns = (long long)(latency_us * 1000);
+    latency_buckets_[bucketOf(ns)].fetch_add(1, std::memory_order_relaxed);
+
+    long long max_ns = max_latency_ns_.load(std::memory_order_relaxed);
+    while (ns > max_ns && !max_latency_ns_.compare_exchange_weak(max_ns, ns, std::memory_order_relaxed)) {
+    }
+
+    if (stolen)
+        stolen_orders_.fetch_add(1, std::memory_order_relaxed);
+}
+
+/**
+* Summarizes every order recorded so far.
+* @return: The latency percentiles and counts.
+*/
+OrderDispatcher::LatencyReport OrderDispatcher::latencyReport() const {
+    std::vector<long> buckets(LATENCY_BUCKETS);
+    LatencyReport report;
+    long orders = 0;
+
+    for (int b = 0; b < LATENCY_BUCKETS; b++) {
+        buckets[b] = latency_buckets_[b].load(std::memory_order_relaxed);
+        orders += buckets[b];
+    }
+
+    report.orders = orders;
+    report.stolen = stolen_orders_.load(std::memory_order_relaxed);
+    report.max_us = max_latency_ns_.load(std::memory_order_relaxed) / 1000.0;
+    if (orders == 0)
+        return report;
+
+    //Nearest-rank percentile, read off the bucket holding that rank
+    auto percentile = [&](double p) {
+        long rank = (long)(p * (orders - 1) + 0.5);
+        int b = 0;
+
+        for (long seen = buckets[0]; seen <= rank; seen += buckets[b])
+            b++;
+
+        return std::min(bucketMiddleUs(b), report.max_us);
+    };
+
+    report.p50_us = percentile(0.50);
+    report.p90_us = percentile(0.90);
+    report.p99_us = percentile(0.99);
+    return report;
+}
+
+/**
+* Discards every recorded latency. Orders finishing meanwhile may or may
+not be kept.
+*/
+void OrderDispatcher::resetLatencies() {
+    for (int b = 0; b < LATENCY_BUCKETS; b++)
+        latency_buckets_[b].store(0, std::memory_order_relaxed);
+
+    max_latency_ns_.store(0, std::memory_order_relaxed);
+    stolen_orders_.store(0, std::memory_order_relaxed);
+}
+
+/**
+* Finds the histogram bucket of a latency.
+* @param ns The latency in nanoseconds.
+* @return: The bucket; the last bucket is unbounded.
+*/
+int OrderDispatcher::bucketOf(long long ns) {
+    if (ns < LATENCY_SUB_BUCKETS)
+        return std::max(ns, 0LL);
+
+    //The top 5 bits of ns: the doubling it falls in, then which 16th of it
+    int top_bit = 63 - __builtin_clzll(ns);
+    int octave = top_bit - 3;
+    int sub = (ns >> (top_bit - 4)) & (LATENCY_SUB_BUCKETS - 1);
+
+    return std::min(octave * LATENCY_SUB_BUCKETS + sub, LATENCY_BUCKETS - 1);
+}
+
+/**
+* Finds the middle of a histogram bucket.
+* @param bucket The bucket.
+* @return: The latency in microseconds halfway through the bucket.
+*/
+double OrderDispatcher::bucketMiddleUs(int bucket) {
+    if (bucket < LATENCY_SUB_BUCKETS)
+        return (bucket + 0.5) / 1000;
+
+    int octave = bucket / LATENCY_SUB_BUCKETS;
+    int sub = bucket % LATENCY_SUB_BUCKETS;
+    double width = std::ldexp(1.0, octave - 1);
+
+    return ((LATENCY_SUB_BUCKETS + sub) * width + width / 2) / 1000;
+}
@@ -0,0 +1,124 @@
+/**
+ * @brief This file contains the declaration of the OrderDispatcher class, which balances orders across station workers in a virtual bistro simulation.
+*/
+
+#ifndef ORDERDISPATCHER_HPP
+#define ORDERDISPATCHER_HPP
+
+#include <vector>
+#include <mutex>
+#include <shared_mutex>
+#include <atomic>
+
+class StationWorker;
+
+class OrderDispatcher {
+    public:
+        /**
+        * Order latency percentiles, measured from the moment an order is
+        queued until its station finishes it. Percentiles come from a
+        histogram and are within 1/LATENCY_SUB_BUCKETS of the true value;
+        max_us is exact.
+        */
+        struct LatencyReport {
+            int orders = 0; //orders finished
+            int stolen = 0; //orders finished by a worker that stole them
+            double p50_us = 0; //median latency in microseconds
+            double p90_us = 0;
+            double p99_us = 0;
+            double max_us = 0;
+        };
+
+        /**
+        * Registers a worker as a peer that can steal and be stolen from.
+        * @param worker A pointer to a running StationWorker.
+        */
+        void addWorker(StationWorker* worker);
+
+        /**
+        * Unregisters a worker.
+        * @param worker A pointer to a registered StationWorker.
+        * @post: No steal involving the worker is in progress or can start.
+        */
+        void removeWorker(StationWorker* worker);
+
+        /**
+        * Moves a queued order from the busiest peer that has one the
+        thief's station can complete into the thief's queue.
+        * @param thief The idle worker looking for work.
+        * @return: True if an order was moved; false otherwise.
+        */
+        bool stealFor(StationWorker& thief);
+
+        /**
+        * Tells the dispatcher an order was queued at a worker.
+        * @param worker The registered worker the order was queued at.
+        * @param queued The worker's queue length after the order was added.
+        * @post: The worker is no longer idle. If it now has a backlog, one
+        idle peer is woken to try to steal it.
+        */
+        void orderQueued(StationWorker* worker, int queued);
+
+        /**
+        * Marks a worker as idle, so that the next backlog can wake it.
+        * @param worker A registered worker with nothing to do.
+        */
+        void markIdle(StationWorker* worker);
+
+        /**
+        * Records a finished order.
+        * @param latency_us The order's latency in microseconds.
+        * @param stolen True if the order was stolen from another worker.
+        */
+        void recordOrder(double latency_us, bool stolen);
+
+        /**
+        * Summarizes every order recorded so far.
+        * @return: The latency percentiles and counts.
+        */
+        LatencyReport latencyReport() const;
+
+        /**
+        * Discards every recorded latency. Orders finishing meanwhile may or
+        may not be kept.
+        */
+        void resetLatencies();
+
+        //Latency buckets per doubling of the latency, so a bucket spans at most 1/16 of its value
+        static const int LATENCY_SUB_BUCKETS = 16;
+
+        //Buckets in all: nanosecond latencies up to 2^(LATENCY_OCTAVES + 3), about 2.4 hours
+        static const int LATENCY_OCTAVES = 40;
+        static const int LATENCY_BUCKETS = LATENCY_SUB_BUCKETS * LATENCY_OCTAVES;
+
+    private:
+        std::vector<StationWorker*> workers_; //registered peers
+        mutable std::shared_mutex workers_mutex_; //shared while stealing, exclusive to add/remove
+
+        std::vector<StationWorker*> idle_; //registered peers waiting to be woken for a backlog
+        std::mutex idle_mutex_; //guards idle_; taken before any worker's queue lock
+
+        //Fixed-size latency histogram, so memory and report time stay bounded
+        //however long the kitchen runs; written with relaxed atomics
+        std::atomic<long> latency_buckets_[LATENCY_BUCKETS] = {};
+        std::atomic<long long> max_latency_ns_{0};
+        std::atomic<long> stolen_orders_{0}; //finished orders that were stolen
+
+        /**
+        * Finds the histogram bucket of a latency.
+        * @param ns The latency in nanoseconds.
+        * @return: The bucket: nanoseconds below LATENCY_SUB_BUCKETS have one
+        bucket each; above that, each doubling is split into
+        LATENCY_SUB_BUCKETS equal buckets. The last bucket is unbounded.
+        */
+        static int bucketOf(long long ns);
+
+        /**
+        * Finds the middle of a histogram bucket.
+        * @param bucket The bucket.
+        * @return: The latency in microseconds halfway through the bucket.
+        */
+        static double bucketMiddleUs(int bucket);
+};
+
+#endif // ORDERDISPATCHER_HPP
@@ -0,0 +1,145 @@
+/**
+ * @brief This file contains the implementation of the OrderPipeline class, which runs asynchronous orders in simulated time on a single thread in a virtual bistro simulation.
+*/
+
+#include "OrderPipeline.hpp"
+#include <algorithm>
+#include <vector>
+
+/**
+* Parameterized Constructor
+* @param manager The stations orders are prepared at.
+* @param wheel_slots Slots of the timer wheel.
+* @post: Initializes an idle pipeline.
+*/
+OrderPipeline::OrderPipeline(StationManager& manager, int wheel_slots)
+    : manager_(manager), wheel_(wheel_slots), next_timer_(1), now_(0) {
+}
+
+/**
+* Starts an order at a specific station without blocking.
+* @param station_name A string representing the station's name.
+* @param dish_name A string representing the name of the dish.
+* @param then Called with true getPrepTime ticks later if the station
+prepared the dish; called with false on the current tick otherwise.
+* @post: The ingredients are deducted now.
+*/
+void OrderPipeline::prepare(const std::string& station_name, const std::string& dish_name, Continuation then) {
+    KitchenStation* station = manager_.findStation(station_name);
+    int prep_time = (station == nullptr) ? -1 : station->getPrepTime(dish_name);
+
+    //The order suspends for its prep time only if the ingredients were taken
+    if (prep_time >= 0 && manager_.prepareDishAtStation(station_name, dish_name))
+        after(prep_time, [then] { then(true); });
+    else
+        after(0, [then] { then(false); });
+}
+
+/**
+* Starts an order at the first station that can complete it.
+* @param dish_name A string representing the name of the dish.
+* @param then As in prepare; called with false if no station can
+complete the dish.
+*/
+void OrderPipeline::dispatch(const std::string& dish_name, Continuation then) {
+    std::vector<KitchenStation*> stations = manager_.capableStations(dish_name);
+
+    if (stations.empty())
+        after(0, [then] { then(false); });
+    else
+        prepare(stations[0]->getName(), dish_name, then);
+}
+
+/**
+* Resumes work after a delay.
+* @param ticks The delay; 0 or less runs task later on the current tick.
+* @param task The work to run.
+*/
+void OrderPipeline::after(long ticks, Task task) {
+    if (ticks <= 0) {
+        ready_.push_back(std::move(task));
+        return;
+    }
+
+    unsigned long id = next_timer_++;
+    waiting_.emplace(id, std::move(task));
+    wheel_.schedule(id, now_ + ticks);
+}
+
+/**
+* Runs everything due up to a point in time.
+* @param tick The time to run to; earlier times are ignored.
+* @post: Every continuation and task due at or before tick has run.
+* @return: The current time.
+*/
+long long OrderPipeline::runUntil(long long tick) {
+    std::vector<unsigned long> due;
+
+    //Work scheduled for the current tick before the run goes first
+    drainReady();
+
+    //One tick at a time, since what runs on a tick may schedule work for the next
+    while (now_ < tick) {
+        if (waiting_.empty()) {
+            now_ = tick;
+            break;
+        }
+
+        now_++;
+        due.clear();
+        wheel_.advance(now_, due);
+
+        //Timers due on one tick come back in slot order; ids restore the order they were scheduled in
+        std::sort(due.begin(), due.end());
+        for (size_t i = 0; i < due.size(); i++) {
+            auto found = waiting_.find(due[i]);
+            ready_.push_back(std::move(found->second));
+            waiting_.erase(found);
+        }
+
+        drainReady();
+    }
+
+    return now_;
+}
+
+/**
+* Runs until nothing is left in flight.
+* @return: The time the last continuation or task ran.
+*/
+long long OrderPipeline::run() {
+    drainReady();
+
+    while (!waiting_.empty())
+        runUntil(now_ + 1);
+
+    return now_;
+}
+
+/**
+* Retrieves the current time.
+* @return: The simulated time in ticks.
+*/
+long long OrderPipeline::now() const {
+    return now_;
+}
+
+/**
+* Retrieves the number of continuations and tasks not run yet.
+* @return: The number in flight.
+*/
+int OrderPipeline::inFlight() const {
+    return waiting_.size() + ready_.size();
+}
+
+/**
+* Runs the work due on the current tick.
+* @post: ready_ is empty; work it adds for the current tick runs too.
+*/
+void OrderPipeline::drainReady() {
+    while (!ready_.empty()) {
+        Task task = std::move(ready_.front());
+        ready_.pop_front();
+        task();
+    }
+}
@@ -0,0 +1,106 @@
+/**
+ * @brief This file contains the declaration of the OrderPipeline class, which runs asynchronous orders in simulated time on a single thread in a virtual bistro simulation.
+*/
+
+#ifndef ORDERPIPELINE_HPP
+#define ORDERPIPELINE_HPP
+
+#include "StationManager.hpp"
+#include "TimerWheel.hpp"
+#include <string>
+#include <functional>
+#include <unordered_map>
+#include <deque>
+
+class OrderPipeline {
+    public:
+        //Resumes an order once it is done; the argument is whether it was prepared
+        typedef std::function<void(bool)> Continuation;
+        //Resumes work after a delay
+        typedef std::function<void()> Task;
+
+        /**
+        * Parameterized Constructor
+        * @param manager The stations orders are prepared at. Times are in
+        ticks, the unit of Dish::getPrepTime, and start at 0.
+        * @param wheel_slots Slots of the timer wheel; delays shorter than
+        this are visited exactly once.
+        * @post: Initializes an idle pipeline.
+        */
+        OrderPipeline(StationManager& manager, int wheel_slots = 4096);
+
+        OrderPipeline(const OrderPipeline&) = delete;
+        OrderPipeline& operator=(const OrderPipeline&) = delete;
+
+        /**
+        * Starts an order at a specific station without blocking.
+        * @param station_name A string representing the station's name.
+        * @param dish_name A string representing the name of the dish.
+        * @param then Called with true getPrepTime ticks later if the station
+        prepared the dish; called with false on the current tick otherwise.
+        * @post: The ingredients are deducted now, through
+        StationManager::prepareDishAtStation. A station cooks any number of
+        orders at once; OrderScheduler models one order at a time.
+        */
+        void prepare(const std::string& station_name, const std::string& dish_name, Continuation then);
+
+        /**
+        * Starts an order at the first station that can complete it.
+        * @param dish_name A string representing the name of the dish.
+        * @param then As in prepare; called with false if no station can
+        complete the dish.
+        */
+        void dispatch(const std::string& dish_name, Continuation then);
+
+        /**
+        * Resumes work after a delay.
+        * @param ticks The delay; 0 or less runs task later on the current
+        tick.
+        * @param task The work to run.
+        */
+        void after(long ticks, Task task);
+
+        /**
+        * Runs everything due up to a point in time.
+        * @param tick The time to run to; earlier times are ignored.
+        * @post: Every continuation and task due at or before tick has run,
+        including those they scheduled in turn, in time order and in the
+        order they were scheduled within a tick.
+        * @return: The current time.
+        */
+        long long runUntil(long long tick);
+
+        /**
+        * Runs until nothing is left in flight.
+        * @return: The time the last continuation or task ran.
+        */
+        long long run();
+
+        /**
+        * Retrieves the current time.
+        * @return: The simulated time in ticks.
+        */
+        long long now() const;
+
+        /**
+        * Retrieves the number of continuations and tasks not run yet.
+        * @return: The number in flight.
+        */
+        int inFlight() const;
+
+    private:
+        StationManager& manager_; //the stations being cooked at
+        TimerWheel wheel_; //deadline of every entry of waiting_
+        std::unordered_map<unsigned long, Task> waiting_; //timer id -> work due later
+        std::deque<Task> ready_; //work due on the current tick, in order
+        unsigned long next_timer_; //id of the next timer; ids grow, so they order timers due on one tick
+        long long now_; //current time
+
+        /**
+        * Runs the work due on the current tick.
+        * @post: ready_ is empty; work it adds for the current tick runs too.
+        */
+        void drainReady();
+};
+
+#endif // ORDERPIPELINE_HPP
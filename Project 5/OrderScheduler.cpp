@@ -0,0 +1,224 @@
+/**
+ * @brief This file contains the implementation of the OrderScheduler class, which schedules orders with promised ready-times across kitchen stations, earliest deadline first, in a virtual bistro simulation.
+*/
+
+#include "OrderScheduler.hpp"
+#include <algorithm>
+
+/**
+* Parameterized Constructor
+* @param manager The stations orders are scheduled on.
+*/
+OrderScheduler::OrderScheduler(StationManager& manager) : manager_(manager), next_ticket_(1), now_(0) {
+}
+
+/**
+* Opens a ticket.
+* @param dish_name A string representing the name of the dish.
+* @param ready_by The promised ready-time.
+* @post: The ticket is queued at the capable station expected to finish
+it first, keyed by its latest start time.
+* @return: The ticket's id; 0 if no station can complete the dish.
+*/
+OrderScheduler::TicketId OrderScheduler::submit(const std::string& dish_name, long ready_by) {
+    TicketId id = next_ticket_;
+
+    if (!placeTicket(id, Ticket{dish_name, std::string(), ready_by, 0}))
+        return 0;
+
+    next_ticket_++;
+    return id;
+}
+
+/**
+* Cancels an open ticket.
+* @param id The ticket's id.
+* @return: True if the ticket was open; false otherwise.
+*/
+bool OrderScheduler::cancel(TicketId id) {
+    auto found = tickets_.find(id);
+
+    if (found == tickets_.end())
+        return false;
+
+    const Ticket& ticket = found->second;
+    StationQueue& station_queue = queues_[ticket.station];
+    station_queue.queue.erase(std::make_pair(ticket.ready_by - ticket.prep_time, id));
+    station_queue.backlog -= ticket.prep_time;
+    tickets_.erase(found);
+    return true;
+}
+
+/**
+* Runs the stations up to a point in time.
+* @param now The time to run to; earlier times are ignored.
+* @post: Every ticket started at or before now has been prepared at its
+station. The queues of stations removed or renamed since are dropped
+first, and their tickets moved to stations that can take them.
+* @return: The tickets started, in the order each station ran them,
+after the tickets of dropped queues no station could take.
+*/
+std::vector<OrderScheduler::Completion> OrderScheduler::advanceTo(long now) {
+    std::vector<Completion> completed;
+
+    if (now < now_)
+        return completed;
+
+    //Dropping the queues whose name no longer leads to their station, before any ticket runs
+    std::vector<std::string> stale;
+    for (auto it = queues_.begin(); it != queues_.end(); it++) {
+        if (manager_.peekStation(it->first) != it->second.station)
+            stale.push_back(it->first);
+    }
+    for (size_t i = 0; i < stale.size(); i++) {
+        //Moving an earlier queue's tickets may already have replaced this one with the current station's
+        auto found = queues_.find(stale[i]);
+        if (found != queues_.end() && manager_.peekStation(stale[i]) != found->second.station)
+            dropQueue(stale[i]);
+    }
+
+    completed.swap(unplaced_);
+
+    for (auto it = queues_.begin(); it != queues_.end(); it++) {
+        StationQueue& station_queue = it->second;
+
+        //A station idle since before the last advance starts no earlier than it
+        station_queue.free_at = std::max(station_queue.free_at, now_);
+
+        //Earliest latest-start-time first, for as long as the station frees up by now
+        while (!station_queue.queue.empty() && station_queue.free_at <= now) {
+            TicketId id = station_queue.queue.begin()->second;
+            station_queue.queue.erase(station_queue.queue.begin());
+
+            Ticket ticket = std::move(tickets_[id]);
+            tickets_.erase(id);
+            station_queue.backlog -= ticket.prep_time;
+
+            Completion completion;
+            completion.id = id;
+            completion.station = it->first;
+            completion.dish_name = ticket.dish_name;
+            completion.prepared = manager_.prepareDishAtStation(it->first, ticket.dish_name);
+            completion.started = station_queue.free_at;
+            completion.finished = completion.started + (completion.prepared ? ticket.prep_time : 0);
+            completion.lateness = std::max(0L, completion.finished - ticket.ready_by);
+
+            station_queue.free_at = completion.finished;
+            completed.push_back(completion);
+        }
+    }
+
+    now_ = now;
+    return completed;
+}
+
+/**
+* Predicts the finish time and lateness of every open ticket.
+* @return: One prediction per open ticket.
+*/
+std::vector<OrderScheduler::Prediction> OrderScheduler::predictLateness() const {
+    std::vector<Prediction> predictions;
+
+    for (auto it = queues_.begin(); it != queues_.end(); it++) {
+        long finish = std::max(it->second.free_at, now_);
+
+        //The set's order is the order the station will run its tickets
+        for (auto entry = it->second.queue.begin(); entry != it->second.queue.end(); entry++) {
+            const Ticket& ticket = tickets_.at(entry->second);
+            finish += ticket.prep_time;
+            predictions.push_back(Prediction{entry->second, it->first, finish, std::max(0L, finish - ticket.ready_by)});
+        }
+    }
+
+    return predictions;
+}
+
+/**
+* Retrieves the number of tickets not started yet.
+* @return: The number of open tickets.
+*/
+int OrderScheduler::openTickets() const {
+    return tickets_.size();
+}
+
+/**
+* Retrieves the current time.
+* @return: The last time passed to advanceTo, or 0.
+*/
+long OrderScheduler::now() const {
+    return now_;
+}
+
+/**
+* Queues a ticket at the capable station expected to finish it first.
+* @param id The ticket's id.
+* @param ticket The ticket; its station and prep time are filled in from
+the station chosen.
+* @return: True if the ticket was queued; false if no station can
+complete the dish.
+*/
+bool OrderScheduler::placeTicket(TicketId id, Ticket ticket) {
+    std::vector<KitchenStation*> stations = manager_.capableStations(ticket.dish_name);
+    KitchenStation* best = nullptr;
+    long best_finish = 0;
+
+    //Picking the station whose current work would be done first
+    for (size_t i = 0; i < stations.size(); i++) {
+        std::string name = stations[i]->getName();
+        auto found = queues_.find(name);
+
+        //A queue left under this name by a removed or renamed station is not this station's work
+        if (found != queues_.end() && found->second.station != stations[i]) {
+            dropQueue(name);
+            found = queues_.end();
+        }
+
+        long finish = now_;
+        if (found != queues_.end())
+            finish = std::max(found->second.free_at, now_) + found->second.backlog;
+
+        if (best == nullptr || finish < best_finish) {
+            best = stations[i];
+            best_finish = finish;
+        }
+    }
+
+    if (best == nullptr)
+        return false;
+
+    //Reading the prep time from the station, since stations may hold different recipes under one name
+    ticket.station = best->getName();
+    ticket.prep_time = std::max(0, best->getPrepTime(ticket.dish_name));
+
+    StationQueue& station_queue = queues_[ticket.station];
+    station_queue.station = best;
+    station_queue.queue.insert(std::make_pair(ticket.ready_by - ticket.prep_time, id));
+    station_queue.backlog += ticket.prep_time;
+    tickets_[id] = std::move(ticket);
+    return true;
+}
+
+/**
+* Drops the queue of a station that was removed or renamed.
+* @param station_name The name the queue is kept under.
+* @post: Its tickets are queued again at the stations that can take them;
+the rest are closed and added to unplaced_.
+*/
+void OrderScheduler::dropQueue(const std::string& station_name) {
+    auto found = queues_.find(station_name);
+
+    if (found == queues_.end())
+        return;
+
+    StationQueue dropped = std::move(found->second);
+    queues_.erase(found);
+
+    for (auto entry = dropped.queue.begin(); entry != dropped.queue.end(); entry++) {
+        TicketId id = entry->second;
+        Ticket ticket = std::move(tickets_[id]);
+        tickets_.erase(id);
+
+        if (!placeTicket(id, ticket))
+            unplaced_.push_back(Completion{id, ticket.station, ticket.dish_name, false, now_, now_, std::max(0L, now_ - ticket.ready_by)});
+    }
+}
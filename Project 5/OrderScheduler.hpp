@@ -0,0 +1,148 @@
+/**
+ * @brief This file contains the declaration of the OrderScheduler class, which schedules orders with promised ready-times across kitchen stations, earliest deadline first, in a virtual bistro simulation.
+*/
+
+#ifndef ORDERSCHEDULER_HPP
+#define ORDERSCHEDULER_HPP
+
+#include "StationManager.hpp"
+#include <string>
+#include <vector>
+#include <set>
+#include <unordered_map>
+#include <utility>
+
+class OrderScheduler {
+    public:
+        typedef unsigned long TicketId;
+
+        /**
+        * A ticket the scheduler ran.
+        */
+        struct Completion {
+            TicketId id;
+            std::string station; //the station the ticket ran at
+            std::string dish_name;
+            bool prepared; //false if the station could no longer make the dish
+            long started; //when the station started the ticket
+            long finished; //started plus the prep time (started if not prepared)
+            long lateness; //how far finished is past the promised time, or 0
+        };
+
+        /**
+        * Where an open ticket stands if every station works through its queue
+        in order from now.
+        */
+        struct Prediction {
+            TicketId id;
+            std::string station;
+            long finish; //predicted finish time
+            long lateness; //how far finish is past the promised time, or 0
+        };
+
+        /**
+        * Parameterized Constructor
+        * @param manager The stations orders are scheduled on. Times are in
+        the unit of Dish::getPrepTime and start at 0.
+        */
+        OrderScheduler(StationManager& manager);
+
+        /**
+        * Opens a ticket.
+        * @param dish_name A string representing the name of the dish.
+        * @param ready_by The promised ready-time.
+        * @post: The ticket is queued at the capable station expected to
+        finish it first, keyed by its latest start time (ready_by minus the
+        dish's prep time). O(log n) in the station's queue length.
+        * @return: The ticket's id; 0 if no station can complete the dish.
+        */
+        TicketId submit(const std::string& dish_name, long ready_by);
+
+        /**
+        * Cancels an open ticket in O(log n).
+        * @param id The ticket's id.
+        * @return: True if the ticket was open; false otherwise.
+        */
+        bool cancel(TicketId id);
+
+        /**
+        * Runs the stations up to a point in time. Whenever a station is free
+        it starts the ticket of its queue with the earliest latest start time.
+        * @param now The time to run to; earlier times are ignored.
+        * @post: Every ticket started at or before now has been prepared at
+        its station. The queues of stations removed or renamed since are
+        dropped first, and their tickets moved to stations that can take
+        them.
+        * @return: The tickets started, in the order each station ran them,
+        after the tickets of dropped queues no station could take (reported
+        as not prepared).
+        */
+        std::vector<Completion> advanceTo(long now);
+
+        /**
+        * Predicts the finish time and lateness of every open ticket, walking
+        each station's queue in the order it will be run.
+        * @return: One prediction per open ticket.
+        */
+        std::vector<Prediction> predictLateness() const;
+
+        /**
+        * Retrieves the number of tickets not started yet.
+        * @return: The number of open tickets.
+        */
+        int openTickets() const;
+
+        /**
+        * Retrieves the current time.
+        * @return: The last time passed to advanceTo, or 0.
+        */
+        long now() const;
+
+    private:
+        /**
+        * An open ticket.
+        */
+        struct Ticket {
+            std::string dish_name;
+            std::string station;
+            long ready_by;
+            int prep_time;
+        };
+
+        /**
+        * One station's queue, ordered by (latest start time, ticket id).
+        */
+        struct StationQueue {
+            KitchenStation* station = nullptr; //the station under the queue's name when it was made; compared, never dereferenced
+            std::set<std::pair<long, TicketId>> queue;
+            long free_at = 0; //when the station finishes what it started
+            long backlog = 0; //prep time of every queued ticket
+        };
+
+        StationManager& manager_; //the stations being scheduled
+        std::unordered_map<TicketId, Ticket> tickets_; //open tickets
+        std::unordered_map<std::string, StationQueue> queues_; //station name -> its queue
+        std::vector<Completion> unplaced_; //tickets of dropped queues no station could take, returned by the next advanceTo
+        TicketId next_ticket_; //id of the next ticket
+        long now_; //current time
+
+        /**
+        * Queues a ticket at the capable station expected to finish it first.
+        * @param id The ticket's id.
+        * @param ticket The ticket; its station and prep time are filled in
+        from the station chosen.
+        * @return: True if the ticket was queued; false if no station can
+        complete the dish.
+        */
+        bool placeTicket(TicketId id, Ticket ticket);
+
+        /**
+        * Drops the queue of a station that was removed or renamed.
+        * @param station_name The name the queue is kept under.
+        * @post: Its tickets are queued again at the stations that can take
+        them; the rest are closed and added to unplaced_.
+        */
+        void dropQueue(const std::string& station_name);
+};
+
+#endif // ORDERSCHEDULER_HPP
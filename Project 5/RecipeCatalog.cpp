@@ -0,0 +1,257 @@
+/**
+ * @brief This file contains the implementation of the RecipeCatalog class, which shares one immutable copy of each distinct recipe between kitchen stations in a virtual bistro simulation.
+*/
+
+#include "RecipeCatalog.hpp"
+#include <functional>
+
+/**
+* Retrieves the catalog every station shares.
+* @return: The process-wide catalog.
+*/
+RecipeCatalog& RecipeCatalog::instance() {
+    //Never destroyed, so stations destroyed during exit can still release their recipes
+    static RecipeCatalog* catalog = new RecipeCatalog();
+    return *catalog;
+}
+
+/**
+* Adds a dish to the catalog, taking ownership of it.
+* @param dish A dynamically allocated dish.
+* @post: If an identical recipe is already in the catalog, that recipe is
+shared instead, and dish is deleted only when the last Recipe returned
+for it is gone.
+* @return: The recipe now standing for dish.
+*/
+RecipeCatalog::Recipe RecipeCatalog::intern(Dish* dish) {
+    //Declared before the lock so recipes dropped here are released after it is let go
+    std::vector<std::shared_ptr<const Dish>> looked_at;
+    Recipe recipe;
+
+    std::lock_guard<std::mutex> lock(catalog_mutex_);
+
+    //The same Dish handed to several stations is simply shared
+    auto same = by_address_.find(dish);
+    if (same != by_address_.end()) {
+        recipe.dish = same->second.shared.lock();
+        if (recipe.dish) {
+            recipe.id = same->second.id;
+            return recipe;
+        }
+    }
+
+    size_t hash = hashRecipe(*dish);
+    auto range = by_content_.equal_range(hash);
+    std::shared_ptr<const Dish> existing;
+
+    for (auto it = range.first; it != range.second && !existing; it++) {
+        looked_at.push_back(entries_[it->second].shared.lock());
+
+        if (looked_at.back() && sameRecipe(*looked_at.back(), *dish)) {
+            recipe.id = it->second;
+            existing = looked_at.back();
+        }
+    }
+
+    if (existing) {
+        //The caller may still use dish, so it lives on beside the shared recipe and is deleted with the last Recipe for it
+        std::shared_ptr<const Dish> keeper(dish, [this, existing](const Dish* gone) { releaseDuplicate(gone); });
+        recipe.dish = std::shared_ptr<const Dish>(keeper, existing.get());
+        by_address_[dish] = Interned{recipe.id, recipe.dish};
+        return recipe;
+    }
+
+    //Taking a free slot or growing the catalog
+    if (free_ids_.empty()) {
+        recipe.id = entries_.size();
+        entries_.emplace_back();
+    }
+    else {
+        recipe.id = free_ids_.back();
+        free_ids_.pop_back();
+    }
+
+    RecipeId id = recipe.id;
+    recipe.dish = std::shared_ptr<const Dish>(dish, [this, id](const Dish* gone) { release(id, gone); });
+
+    entries_[id].shared = recipe.dish;
+    entries_[id].hash = hash;
+    by_content_.emplace(hash, id);
+    by_address_[dish] = Interned{id, recipe.dish};
+    return recipe;
+}
+
+/**
+* Looks up a recipe by id.
+* @param id An id returned by intern.
+* @return: The recipe; its dish is nullptr if no station refers to the id
+any more.
+*/
+RecipeCatalog::Recipe RecipeCatalog::find(RecipeId id) const {
+    std::lock_guard<std::mutex> lock(catalog_mutex_);
+    Recipe recipe;
+
+    if (id >= 0 && static_cast<size_t>(id) < entries_.size()) {
+        recipe.id = id;
+        recipe.dish = entries_[id].shared.lock();
+    }
+
+    return recipe;
+}
+
+/**
+* Retrieves the number of distinct recipes still referred to.
+* @return: The number of live recipes.
+*/
+int RecipeCatalog::size() const {
+    std::lock_guard<std::mutex> lock(catalog_mutex_);
+    return entries_.size() - free_ids_.size();
+}
+
+/**
+* Registers a dish name, giving it an id if it has none yet.
+* @param dish_name A string representing the name of the dish.
+* @return: The name's id.
+*/
+RecipeCatalog::DishId RecipeCatalog::registerDish(const std::string& dish_name) {
+    DishId id = findDishId(dish_name);
+    if (id != -1)
+        return id;
+
+    std::lock_guard<std::shared_mutex> lock(names_mutex_);
+
+    //Another thread may have registered the name between the two locks
+    auto found = dish_ids_.find(dish_name);
+    if (found != dish_ids_.end())
+        return found->second;
+
+    id = dish_names_.size();
+    dish_ids_.emplace(dish_name, id);
+    dish_names_.push_back(dish_name);
+    return id;
+}
+
+/**
+* Looks up the id of a dish name without registering it.
+* @param dish_name A string representing the name of the dish.
+* @return: The name's id; -1 if the name was never registered.
+*/
+RecipeCatalog::DishId RecipeCatalog::findDishId(const std::string& dish_name) const {
+    std::shared_lock<std::shared_mutex> lock(names_mutex_);
+    auto found = dish_ids_.find(dish_name);
+
+    return (found == dish_ids_.end()) ? -1 : found->second;
+}
+
+/**
+* Looks up the name of a dish id.
+* @param id An id returned by registerDish.
+* @return: The name; an empty string if id is not registered.
+*/
+std::string RecipeCatalog::dishName(DishId id) const {
+    std::shared_lock<std::shared_mutex> lock(names_mutex_);
+
+    if (id < 0 || static_cast<size_t>(id) >= dish_names_.size())
+        return "";
+
+    return dish_names_[id];
+}
+
+/**
+* Retrieves the number of registered dish names.
+* @return: One more than the largest DishId handed out.
+*/
+int RecipeCatalog::dishCount() const {
+    std::shared_lock<std::shared_mutex> lock(names_mutex_);
+    return dish_names_.size();
+}
+
+/**
+* Frees a slot once its dish is deleted.
+* @param id The slot's id.
+* @param dish The dish being deleted.
+*/
+void RecipeCatalog::release(RecipeId id, const Dish* dish) {
+    {
+        std::lock_guard<std::mutex> lock(catalog_mutex_);
+        Entry& entry = entries_[id];
+
+        auto range = by_content_.equal_range(entry.hash);
+        for (auto it = range.first; it != range.second; it++) {
+            if (it->second == id) {
+                by_content_.erase(it);
+                break;
+            }
+        }
+
+        auto address = by_address_.find(dish);
+        if (address != by_address_.end() && address->second.id == id)
+            by_address_.erase(address);
+        entry = Entry();
+        free_ids_.push_back(id);
+    }
+
+    delete dish;
+}
+
+/**
+* Deletes a duplicate once no Recipe refers to it.
+* @param dish The duplicate being deleted.
+*/
+void RecipeCatalog::releaseDuplicate(const Dish* dish) {
+    {
+        std::lock_guard<std::mutex> lock(catalog_mutex_);
+        by_address_.erase(dish);
+    }
+
+    delete dish;
+}
+
+/**
+* Hashes everything that makes two recipes the same.
+* @param dish The dish to hash.
+* @return: The hash.
+*/
+size_t RecipeCatalog::hashRecipe(const Dish& dish) {
+    std::vector<Ingredient> ingre = dish.getIngredients();
+    size_t hash = std::hash<std::string>()(dish.getName());
+
+    //Mixing each field in turn (boost::hash_combine)
+    auto mix = [&hash](size_t value) { hash ^= value + 0x9e3779b9 + (hash << 6) + (hash >> 2); };
+
+    mix(std::hash<std::string>()(dish.getCuisineType()));
+    mix(std::hash<int>()(dish.getPrepTime()));
+    mix(std::hash<double>()(dish.getPrice()));
+    for (size_t i = 0; i < ingre.size(); i++) {
+        mix(std::hash<std::string>()(ingre[i].name));
+        mix(std::hash<int>()(ingre[i].quantity));
+        mix(std::hash<int>()(ingre[i].required_quantity));
+        mix(std::hash<double>()(ingre[i].price));
+    }
+
+    return hash;
+}
+
+/**
+* Compares everything that makes two recipes the same.
+* @return: True if a and b have the same name, cuisine, prep time, price
+and ingredients (in the same order).
+*/
+bool RecipeCatalog::sameRecipe(const Dish& a, const Dish& b) {
+    if (a != b)
+        return false;
+
+    std::vector<Ingredient> a_ingre = a.getIngredients();
+    std::vector<Ingredient> b_ingre = b.getIngredients();
+
+    if (a_ingre.size() != b_ingre.size())
+        return false;
+
+    for (size_t i = 0; i < a_ingre.size(); i++) {
+        if (a_ingre[i].name != b_ingre[i].name || a_ingre[i].quantity != b_ingre[i].quantity
+            || a_ingre[i].required_quantity != b_ingre[i].required_quantity || a_ingre[i].price != b_ingre[i].price)
+            return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,153 @@
+/**
+ * @brief This file contains the declaration of the RecipeCatalog class, which shares one immutable copy of each distinct recipe between kitchen stations in a virtual bistro simulation.
+*/
+
+#ifndef RECIPECATALOG_HPP
+#define RECIPECATALOG_HPP
+
+#include "Dish.hpp"
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class RecipeCatalog {
+    public:
+        typedef int RecipeId;
+        //Dense id of a dish name, shared by every recipe of that name; ids are never reused
+        typedef int DishId;
+
+        /**
+        * A shared, immutable recipe and its id in the catalog. The Dish lives
+        as long as some Recipe refers to it.
+        */
+        struct Recipe {
+            RecipeId id = -1;
+            std::shared_ptr<const Dish> dish;
+        };
+
+        /**
+        * Retrieves the catalog every station shares.
+        * @return: The process-wide catalog.
+        */
+        static RecipeCatalog& instance();
+
+        RecipeCatalog() = default;
+        RecipeCatalog(const RecipeCatalog&) = delete;
+        RecipeCatalog& operator=(const RecipeCatalog&) = delete;
+
+        /**
+        * Adds a dish to the catalog, taking ownership of it.
+        * @param dish A dynamically allocated dish.
+        * @post: If a recipe with the same name, cuisine, prep time, price and
+        ingredients is already in the catalog, that recipe is shared
+        instead. dish then stays allocated, and valid for the caller, until
+        the last Recipe returned for it is gone, and is deleted with it.
+        * @return: The recipe now standing for dish.
+        */
+        Recipe intern(Dish* dish);
+
+        /**
+        * Looks up a recipe by id.
+        * @param id An id returned by intern.
+        * @return: The recipe; its dish is nullptr if no station refers to
+        the id any more.
+        */
+        Recipe find(RecipeId id) const;
+
+        /**
+        * Retrieves the number of distinct recipes still referred to.
+        * @return: The number of live recipes.
+        */
+        int size() const;
+
+        /**
+        * Registers a dish name, giving it an id if it has none yet.
+        * @param dish_name A string representing the name of the dish.
+        * @return: The name's id; ids are handed out as 0, 1, 2, ... in
+        registration order.
+        */
+        DishId registerDish(const std::string& dish_name);
+
+        /**
+        * Looks up the id of a dish name without registering it.
+        * @param dish_name A string representing the name of the dish.
+        * @return: The name's id; -1 if the name was never registered.
+        */
+        DishId findDishId(const std::string& dish_name) const;
+
+        /**
+        * Looks up the name of a dish id.
+        * @param id An id returned by registerDish.
+        * @return: The name; an empty string if id is not registered.
+        */
+        std::string dishName(DishId id) const;
+
+        /**
+        * Retrieves the number of registered dish names.
+        * @return: One more than the largest DishId handed out.
+        */
+        int dishCount() const;
+
+    private:
+        /**
+        * A catalog slot. A slot is free (and its id reusable) once the last
+        Recipe referring to it is gone.
+        */
+        struct Entry {
+            std::weak_ptr<const Dish> shared; //expired while the slot is free
+            size_t hash = 0;
+        };
+
+        /**
+        * A Dish handed to intern that is still alive, either as a recipe or
+        as a duplicate kept for its caller.
+        */
+        struct Interned {
+            RecipeId id;
+            std::weak_ptr<const Dish> shared; //what intern returned for the Dish
+        };
+
+        std::vector<Entry> entries_; //id -> slot
+        std::vector<RecipeId> free_ids_; //ids of free slots
+        std::unordered_multimap<size_t, RecipeId> by_content_; //recipe hash -> ids with that hash
+        std::unordered_map<const Dish*, Interned> by_address_; //live dish -> its recipe
+        mutable std::mutex catalog_mutex_; //guards everything above
+
+        std::unordered_map<std::string, DishId> dish_ids_; //dish name -> id
+        std::vector<std::string> dish_names_; //id -> dish name
+        mutable std::shared_mutex names_mutex_; //guards dish_ids_ and dish_names_; names are looked up far more often than added
+
+        /**
+        * Frees a slot once its dish is deleted. Runs as the shared
+        pointer's deleter.
+        * @param id The slot's id.
+        * @param dish The dish being deleted.
+        */
+        void release(RecipeId id, const Dish* dish);
+
+        /**
+        * Deletes a duplicate once no Recipe refers to it. Runs as the
+        shared pointer's deleter.
+        * @param dish The duplicate being deleted.
+        */
+        void releaseDuplicate(const Dish* dish);
+
+        /**
+        * Hashes everything that makes two recipes the same.
+        * @param dish The dish to hash.
+        * @return: The hash.
+        */
+        static size_t hashRecipe(const Dish& dish);
+
+        /**
+        * Compares everything that makes two recipes the same.
+        * @return: True if a and b have the same name, cuisine, prep time,
+        price and ingredients (in the same order).
+        */
+        static bool sameRecipe(const Dish& a, const Dish& b);
+};
+
+#endif // RECIPECATALOG_HPP
@@ -5,12 +5,15 @@
 */
 
 #include "StationManager.hpp"
+#include <algorithm>
+#include <sstream>
 
 /**
 * Default Constructor
 * @post: Initializes an empty station manager.
 */
-StationManager::StationManager() : LinkedList<KitchenStation*>() {
+StationManager::StationManager()
+    : LinkedList<KitchenStation*>(), access_policy_(STATIC_ORDER), counts_sorted_(false), workers_running_(false), route_generation_(0), snapshot_interval_(0), events_since_snapshot_(0) {
 }
 
 /**
@@ -18,9 +21,14 @@ StationManager::StationManager() : LinkedList<KitchenStation*>() {
 * @post: Deallocates all kitchen stations and clears the list.
 */
 StationManager::~StationManager() {
-    for (int i = 0; i < getLength(); i++) {
-        delete getEntry(i);
-    }
+    stopMetricsExport();
+    stopWorkers();
+    stopEventLog();
+
+    for (Node<KitchenStation*>* cur = getHeadNode(); cur != nullptr; cur = cur->getNext())
+        delete cur->getItem();
+
+    station_index_.clear();
     clear();
 }
 
@@ -32,7 +40,46 @@ StationManager::~StationManager() {
 otherwise.
 */
 bool StationManager::addStation(KitchenStation* station) {
-    return insert(getLength(), station);
+    Metrics::Timer timer(metrics_, Metrics::ADD_STATION);
+
+    //Rejecting stations that could not be looked up by name
+    if (station == nullptr || station_index_.count(station->getName()) > 0)
+        return false;
+
+    //Appending after the tail, which the list keeps track of
+    Node<KitchenStation*>* tail = getTailNode();
+
+    {
+        std::lock_guard<std::mutex> lock(list_mutex_);
+        insertAfter(tail, station);
+    }
+    station_index_[station->getName()] = tail;
+
+    //Never looked up, so it belongs at the back of a list sorted by access count
+    if (counts_sorted_)
+        count_leaders_.emplace(0, station);
+
+    //Dishes the station can already make are not in any cached entry yet
+    invalidateRoutes(station);
+    station->setAvailabilityListener([this](KitchenStation* changed, RecipeCatalog::DishId dish_id, bool available) {
+        onAvailabilityChange(changed, dish_id, available);
+    });
+    station->setRenameListener([this](KitchenStation* renamed, const std::string& new_name) {
+        return onRename(renamed, new_name);
+    });
+
+    if (event_log_) {
+        InventoryLog::Writer body;
+        body.putStation(station->getName(), station->getDishes(), station->getIngredientsStock());
+        logEvent(InventoryLog::ADD_STATION, body);
+        watchStock(station);
+    }
+
+    if (workers_running_)
+        workers_[station] = std::unique_ptr<StationWorker>(new StationWorker(station, &dispatcher_));
+
+    snapshotIfDue();
+    return true;
 }
 
 /**
@@ -43,18 +90,24 @@ bool StationManager::addStation(KitchenStation* station) {
 otherwise.
 */
 bool StationManager::removeStation(const std::string& station_name) {
-    for (int i = 0; i < getLength(); i++) {
-        //Storing the data into station
-        KitchenStation* station = getEntry(i); 
+    Metrics::Timer timer(metrics_, Metrics::REMOVE_STATION);
 
-        if (station->getName() == station_name) {
-            delete getEntry(i);
-            remove(i);
-            return true;
-        }
-    }
+    if (peekStation(station_name) == nullptr)
+        return false;
 
-    return false;
+    //Unlinked so no new orders reach it, then drained so its last orders are logged
+    KitchenStation* station = unlinkStation(station_name);
+    stopWorker(station);
+
+    //Logged once the station's last orders are, so replay finds it still there for them
+    InventoryLog::Writer body;
+    body.putString(station_name);
+    logEvent(InventoryLog::REMOVE_STATION, body);
+
+    delete station;
+
+    snapshotIfDue();
+    return true;
 }
 
 /**
@@ -64,15 +117,32 @@ bool StationManager::removeStation(const std::string& station_name) {
 otherwise.
 */
 KitchenStation* StationManager::findStation(const std::string& station_name) {
-    for (int i = 0; i < getLength(); i++) {
-        //Storing the data into station
-        KitchenStation* station = getEntry(i);
+    auto found = station_index_.find(station_name);
 
-        if (station->getName() == station_name)
-            return station;
-    }
+    if (found == station_index_.end())
+        return nullptr;
+
+    KitchenStation* station = nodeAfter(found->second)->getItem();
+
+    if (access_policy_ != STATIC_ORDER)
+        recordAccess(found->second);
+
+    return station;
+}
+
+/**
+* Finds a station by name without counting an access.
+* @param station_name A string representing the station's name.
+* @return: A pointer to the KitchenStation if found; nullptr
+otherwise.
+*/
+KitchenStation* StationManager::peekStation(const std::string& station_name) const {
+    auto found = station_index_.find(station_name);
 
-    return nullptr;
+    if (found == station_index_.end())
+        return nullptr;
+
+    return nodeAfter(found->second)->getItem();
 }
 
 /**
@@ -80,23 +150,81 @@ KitchenStation* StationManager::findStation(const std::string& station_name) {
 list.
 * @param station_name A string representing the station's name.
 * @post: The station is moved to the front of the list if it
-exists.
+exists. Under FREQUENCY_COUNT the next lookup sorts the list by
+access count again.
 * @return: True if the station was found and moved; false
 otherwise.
 */
 bool StationManager::moveStationToFront(const std::string& station_name) {
-    for (int i = 0; i < getLength(); i++) {
-        //Storing the data into station
-        KitchenStation* station = getEntry(i);
+    auto found = station_index_.find(station_name);
 
-        if (station->getName() == station_name) {
-            remove(i);
-            insert(0, station);
-            return true;
-        }
-    }
+    if (found == station_index_.end())
+        return false;
 
-    return false;
+    if (found->second != nullptr)
+        counts_sorted_ = false;
+
+    relinkStation(found->second, nullptr);
+    return true;
+}
+
+/**
+* Selects how the list reorganizes itself on lookups.
+* @param policy The policy.
+* @post: Switching to FREQUENCY_COUNT sorts the list by the accesses
+counted so far, keeping the order of stations with equal counts.
+*/
+void StationManager::setAccessPolicy(AccessPolicy policy) {
+    access_policy_ = policy;
+    counts_sorted_ = false;
+
+    if (policy == FREQUENCY_COUNT)
+        sortByAccessCount();
+}
+
+/**
+* Retrieves how the list reorganizes itself on lookups.
+* @return: The current policy.
+*/
+StationManager::AccessPolicy StationManager::accessPolicy() const {
+    return access_policy_;
+}
+
+/**
+* Retrieves how often a station was looked up while an adaptive policy
+was on.
+* @param station_name A string representing the station's name.
+* @return: The access count; 0 if the station does not exist.
+*/
+long StationManager::getAccessCount(const std::string& station_name) const {
+    auto found = station_index_.find(station_name);
+
+    if (found == station_index_.end())
+        return 0;
+
+    auto count = access_counts_.find(nodeAfter(found->second)->getItem());
+    return (count == access_counts_.end()) ? 0 : count->second;
+}
+
+/**
+* Finds how deep a station sits in the list.
+* @param station_name A string representing the station's name.
+* @return: The station's position, 0 for the front; -1 if the station
+does not exist.
+*/
+int StationManager::getStationPosition(const std::string& station_name) const {
+    auto found = station_index_.find(station_name);
+
+    if (found == station_index_.end())
+        return -1;
+
+    Node<KitchenStation*>* node = nodeAfter(found->second);
+    int position = 0;
+
+    for (Node<KitchenStation*>* cur = getHeadNode(); cur != node; cur = cur->getNext())
+        position++;
+
+    return position;
 }
 
 /**
@@ -104,35 +232,36 @@ bool StationManager::moveStationToFront(const std::string& station_name) {
 * @param station_name1 The name of the first station.
 * @param station_name2 The name of the second station.
 * @post: The second station is removed from the list, and its
-contents are added to the first station.
+contents are added to the first station. The second station is then
+deallocated; its reservations are released into the first station.
 * @return: True if both stations were found and merged; false
 otherwise.
 */
 bool StationManager::mergeStations(const std::string& station_name1, const std::string& station_name2) {
+    Metrics::Timer timer(metrics_, Metrics::MERGE_STATIONS);
+
     //Storing the data into their own pointer to KitchenStation
-    KitchenStation* station1 = findStation(station_name1);
-    KitchenStation* station2 = findStation(station_name2);
+    KitchenStation* station1 = peekStation(station_name1);
+    KitchenStation* station2 = peekStation(station_name2);
 
-    //If both station_name1 and station_name2 are found
-    if (station1 != nullptr && station2 != nullptr) { 
+    //If both station_name1 and station_name2 are found and distinct
+    if (station1 != nullptr && station2 != nullptr && station1 != station2) { 
         //Removing the second station from the list
-        for (int i = 0; i < getLength(); i++) {
-            if (station2->getName() == getEntry(i)->getName())
-                remove(i);
-        }
-
-        std::vector<Dish*> dishes = station2->getDishes();
-
-        //Adding station_name2 dishes into station_name1
-        for (int i = 0; i < dishes.size(); i++) 
-            station1->assignDishToStation(dishes[i]);
-        
-        std::vector<Ingredient> ingre = station2->getIngredientsStock();
-        
-        //Adding station_name2 ingredients into station_name1
-        for (int i = 0; i < ingre.size(); i++) 
-            station1->replenishStationIngredients(ingre[i]);
-        
+        unlinkStation(station_name2);
+        stopWorker(station2);
+
+        //Logged once station2's last orders are, and before station1 can use the merged stock
+        InventoryLog::Writer body;
+        body.putString(station_name1);
+        body.putString(station_name2);
+        logEvent(InventoryLog::MERGE_STATIONS, body);
+
+        //Moving station_name2 dishes and ingredients into station_name1 in bulk;
+        //whatever is left in station2 (dishes station1 already had) is freed with it
+        station1->absorb(std::move(*station2));
+        delete station2;
+
+        snapshotIfDue();
         return true;
     }
     
@@ -148,12 +277,15 @@ bool StationManager::mergeStations(const std::string& station_name1, const std::
 false otherwise.
 */
 bool StationManager::assignDishToStation(const std::string& station_name, Dish* dish) {
+    Metrics::Timer timer(metrics_, Metrics::ASSIGN);
+
     //Storing the data into station
     KitchenStation* station = findStation(station_name);
     
     //Checking if the station exists before adding dish to station
     if (station != nullptr) {
         station->assignDishToStation(dish);
+        snapshotIfDue();
         return true;
     }
 
@@ -169,12 +301,15 @@ bool StationManager::assignDishToStation(const std::string& station_name, Dish*
 replenished; false otherwise.
 */
 bool StationManager::replenishIngredientAtStation(const std::string& station_name, const Ingredient& ingredient) {
+    Metrics::Timer timer(metrics_, Metrics::REPLENISH);
+
     //Storing the data into station
     KitchenStation* station = findStation(station_name);
 
     //Checking if the station exists before adding ingredient to station
     if (station != nullptr) {
         station->replenishStationIngredients(ingredient);
+        snapshotIfDue();
         return true;
     }
 
@@ -189,16 +324,261 @@ order for a specific dish.
 otherwise.
 */
 bool StationManager::canCompleteOrder(const std::string& dish_name) {
-    for (int i = 0; i < getLength(); i++) {
-        //Storing the data into station
-        KitchenStation* station = getEntry(i);
+    return canCompleteOrder(RecipeCatalog::instance().findDishId(dish_name));
+}
 
-        //Return true once the first station is found that can complete the order
-        if (station->canCompleteOrder(dish_name))
-            return true;
+/**
+* Checks if any station in the station manager can complete an order
+for a specific dish.
+* @param dish_id The dish's id, from findDishId.
+* @return: True if any station can complete the order; false
+otherwise.
+*/
+bool StationManager::canCompleteOrder(RecipeCatalog::DishId dish_id) {
+    //A name never registered belongs to no station
+    if (dish_id < 0)
+        return false;
+
+    //Without a pool the full answer costs the same and is cached for next time
+    if (!std::atomic_load(&check_pool_))
+        return !capableStations(dish_id).empty();
+
+    Metrics::Timer timer(metrics_, Metrics::CAN_COMPLETE);
+    unsigned long generation;
+    bool missed_before;
+    {
+        std::lock_guard<std::mutex> lock(route_mutex_);
+        auto found = route_cache_.find(dish_id);
+
+        if (found != route_cache_.end())
+            return !found->second.empty();
+
+        generation = route_generation_;
+        missed_before = !route_misses_.insert(dish_id).second;
     }
 
-    return false;
+    //An early exit caches nothing, so a dish asked about again gets the full, cached answer
+    if (missed_before)
+        return !capableStations(dish_id).empty();
+
+    std::vector<KitchenStation*> stations;
+    for (Node<KitchenStation*>* cur = getHeadNode(); cur != nullptr; cur = cur->getNext())
+        stations.push_back(cur->getItem());
+
+    //Every chunk stops as soon as any chunk finds a capable station
+    std::atomic<bool> capable(false);
+    forEachStationChunk(stations, [&](int begin, int end) {
+        for (int i = begin; i < end && !capable.load(std::memory_order_relaxed); i++) {
+            if (stations[i]->isAvailable(dish_id))
+                capable.store(true, std::memory_order_relaxed);
+        }
+    });
+
+    //Having asked every station without finding one, the empty answer is the full one
+    if (!capable) {
+        std::lock_guard<std::mutex> lock(route_mutex_);
+        if (route_generation_ == generation)
+            route_cache_[dish_id] = std::vector<KitchenStation*>();
+    }
+
+    return capable;
+}
+
+/**
+* Checks a whole list of dishes at once.
+* @param dish_names The names of the dishes.
+* @return: For each dish, in the same sequence, whether any station can
+complete an order for it.
+*/
+std::vector<bool> StationManager::canCompleteOrders(const std::vector<std::string>& dish_names) {
+    std::vector<RecipeCatalog::DishId> dish_ids(dish_names.size());
+
+    for (size_t i = 0; i < dish_names.size(); i++)
+        dish_ids[i] = RecipeCatalog::instance().findDishId(dish_names[i]);
+
+    return canCompleteOrders(dish_ids);
+}
+
+/**
+* Checks a whole list of dishes at once.
+* @param dish_ids The dishes' ids, from findDishId.
+* @return: For each dish, in the same sequence, whether any station can
+complete an order for it.
+*/
+std::vector<bool> StationManager::canCompleteOrders(const std::vector<RecipeCatalog::DishId>& dish_ids) {
+    Metrics::Timer timer(metrics_, Metrics::CAN_COMPLETE);
+    std::vector<bool> answers(dish_ids.size(), false);
+    std::vector<int> unknown;
+
+    //Answering what the routing cache knows; unregistered names belong to no station
+    {
+        std::lock_guard<std::mutex> lock(route_mutex_);
+
+        for (size_t i = 0; i < dish_ids.size(); i++) {
+            if (dish_ids[i] < 0)
+                continue;
+
+            auto found = route_cache_.find(dish_ids[i]);
+
+            if (found != route_cache_.end())
+                answers[i] = !found->second.empty();
+            else
+                unknown.push_back(i);
+        }
+    }
+
+    if (unknown.empty())
+        return answers;
+
+    std::vector<KitchenStation*> stations;
+    for (Node<KitchenStation*>* cur = getHeadNode(); cur != nullptr; cur = cur->getNext())
+        stations.push_back(cur->getItem());
+
+    //One batched check per station; a dish found available is not asked about again
+    std::unique_ptr<std::atomic<bool>[]> capable(new std::atomic<bool>[unknown.size()]);
+    std::atomic<int> remaining(unknown.size());
+    for (size_t k = 0; k < unknown.size(); k++)
+        capable[k].store(false, std::memory_order_relaxed);
+
+    forEachStationChunk(stations, [&](int begin, int end) {
+        std::vector<int> pending;
+        std::vector<RecipeCatalog::DishId> ids;
+
+        for (int i = begin; i < end && remaining.load(std::memory_order_relaxed) > 0; i++) {
+            pending.clear();
+            ids.clear();
+            for (size_t k = 0; k < unknown.size(); k++) {
+                if (!capable[k].load(std::memory_order_relaxed)) {
+                    pending.push_back(k);
+                    ids.push_back(dish_ids[unknown[k]]);
+                }
+            }
+
+            std::vector<bool> station_answers = stations[i]->areAvailable(ids);
+            for (size_t p = 0; p < pending.size(); p++) {
+                if (station_answers[p] && !capable[pending[p]].exchange(true, std::memory_order_relaxed))
+                    remaining.fetch_sub(1, std::memory_order_relaxed);
+            }
+        }
+    });
+
+    for (size_t k = 0; k < unknown.size(); k++)
+        answers[unknown[k]] = capable[k].load(std::memory_order_relaxed);
+
+    return answers;
+}
+
+/**
+* Looks up the id the id-based operations take for a dish name.
+* @param dish_name A string representing the name of the dish.
+* @return: The dish's id; -1 if no station has ever been assigned the
+dish.
+*/
+RecipeCatalog::DishId StationManager::findDishId(const std::string& dish_name) const {
+    return RecipeCatalog::instance().findDishId(dish_name);
+}
+
+/**
+* Resolves a dish id back to its name.
+* @param dish_id The dish's id, from findDishId.
+* @return: The name; an empty string if dish_id is not registered.
+*/
+std::string StationManager::dishName(RecipeCatalog::DishId dish_id) const {
+    return RecipeCatalog::instance().dishName(dish_id);
+}
+
+/**
+* Sets how many pool threads check stations in parallel on a routing
+cache miss.
+* @param thread_count The number of pool threads; 0 to check the
+stations one by one on the calling thread.
+*/
+void StationManager::setParallelChecks(int thread_count) {
+    std::shared_ptr<ThreadPool> pool = std::atomic_load(&check_pool_);
+
+    //The old pool is joined once the last check using it lets go
+    if (thread_count <= 0)
+        std::atomic_store(&check_pool_, std::shared_ptr<ThreadPool>());
+    else if (!pool || pool->size() != thread_count)
+        std::atomic_store(&check_pool_, std::make_shared<ThreadPool>(thread_count));
+}
+
+/**
+* Retrieves how many pool threads check stations in parallel.
+* @return: The number of pool threads; 0 if parallel checks are off.
+*/
+int StationManager::parallelChecks() const {
+    std::shared_ptr<ThreadPool> pool = std::atomic_load(&check_pool_);
+    return pool ? pool->size() : 0;
+}
+
+/**
+* Retrieves every station that can currently complete an order for
+a specific dish.
+* @param dish_name A string representing the name of the dish.
+* @return: The capable stations, in no particular order. Answered from
+the routing cache when possible.
+*/
+std::vector<KitchenStation*> StationManager::capableStations(const std::string& dish_name) {
+    return capableStations(RecipeCatalog::instance().findDishId(dish_name));
+}
+
+/**
+* Retrieves every station that can currently complete an order for
+a specific dish.
+* @param dish_id The dish's id, from findDishId.
+* @return: The capable stations, in no particular order. Answered from
+the routing cache when possible.
+*/
+std::vector<KitchenStation*> StationManager::capableStations(RecipeCatalog::DishId dish_id) {
+    //A name never registered belongs to no station
+    if (dish_id < 0)
+        return std::vector<KitchenStation*>();
+
+    Metrics::Timer timer(metrics_, Metrics::CAN_COMPLETE);
+    unsigned long generation;
+    {
+        std::lock_guard<std::mutex> lock(route_mutex_);
+        auto found = route_cache_.find(dish_id);
+
+        if (found != route_cache_.end())
+            return found->second;
+
+        generation = route_generation_;
+    }
+
+    //Cache miss: asking every station, without holding the cache lock
+    std::vector<KitchenStation*> stations;
+    if (!std::atomic_load(&check_pool_)) {
+        for (Node<KitchenStation*>* cur = getHeadNode(); cur != nullptr; cur = cur->getNext()) {
+            if (cur->getItem()->isAvailable(dish_id))
+                stations.push_back(cur->getItem());
+        }
+    }
+    else {
+        std::vector<KitchenStation*> all;
+        for (Node<KitchenStation*>* cur = getHeadNode(); cur != nullptr; cur = cur->getNext())
+            all.push_back(cur->getItem());
+
+        //Each chunk writes only its own flags
+        std::vector<char> capable(all.size(), 0);
+        forEachStationChunk(all, [&](int begin, int end) {
+            for (int i = begin; i < end; i++)
+                capable[i] = all[i]->isAvailable(dish_id);
+        });
+
+        for (size_t i = 0; i < all.size(); i++) {
+            if (capable[i])
+                stations.push_back(all[i]);
+        }
+    }
+
+    //Only caching the answer if no station changed while it was computed
+    std::lock_guard<std::mutex> lock(route_mutex_);
+    if (route_generation_ == generation)
+        route_cache_[dish_id] = stations;
+
+    return stations;
 }
 
 /**
@@ -211,12 +591,1266 @@ used ingredients at the station.
 otherwise.
 */
 bool StationManager::prepareDishAtStation(const std::string& station_name, const std::string& dish_name_) {
+    Metrics::Timer timer(metrics_, Metrics::PREPARE);
+
     //Storing the data into station
     KitchenStation* station = findStation(station_name);
 
     //Checking if station exists
-    if (station != nullptr)
-        return station->prepareDish(dish_name_);
+    if (station == nullptr)
+        return false;
 
-    return true;
-}
\ No newline at end of file
+    bool prepared = station->prepareDish(dish_name_);
+    snapshotIfDue();
+    return prepared;
+}
+
+/**
+* Prepares a dish at a specific station if possible.
+* @param station_name A string representing the station's name.
+* @param dish_id The dish's id, from findDishId.
+* @return: True if the dish was prepared successfully; false
+otherwise.
+*/
+bool StationManager::prepareDishAtStation(const std::string& station_name, RecipeCatalog::DishId dish_id) {
+    return prepareDishAtStation(findStation(station_name), dish_id);
+}
+
+/**
+* Prepares a dish at a station already looked up, skipping the search
+by name.
+* @param station A station of this manager, from findStation or
+capableStations, that has not been removed or merged away since; or
+nullptr.
+* @param dish_id The dish's id, from findDishId.
+* @return: True if the dish was prepared successfully; false
+otherwise (including when station is nullptr).
+*/
+bool StationManager::prepareDishAtStation(KitchenStation* station, RecipeCatalog::DishId dish_id) {
+    Metrics::Timer timer(metrics_, Metrics::PREPARE);
+
+    if (station == nullptr)
+        return false;
+
+    bool prepared = station->prepareDish(dish_id);
+    snapshotIfDue();
+    return prepared;
+}
+
+/**
+* Prepares a burst of orders at a specific station with one
+feasibility check and one deduction per ingredient.
+* @param station_name A string representing the station's name.
+* @param orders (dish name, servings) pairs.
+* @return: The number of servings prepared for each order, in the
+same sequence as orders; all 0 if the station does not exist.
+*/
+std::vector<int> StationManager::prepareBatch(const std::string& station_name, const std::vector<std::pair<std::string, int>>& orders) {
+    Metrics::Timer timer(metrics_, Metrics::PREPARE_BATCH);
+
+    //Storing the data into station
+    KitchenStation* station = findStation(station_name);
+
+    //Checking if station exists
+    if (station == nullptr)
+        return std::vector<int>(orders.size(), 0);
+
+    std::vector<int> prepared = station->prepareBatch(orders);
+    snapshotIfDue();
+    return prepared;
+}
+
+/**
+* Plans the cheapest restocking that covers a forecast of orders. The
+plan is greedy: a dish's whole forecast goes to the first station in the
+list that has the dish, and demand is never split between stations.
+* @param forecast (dish name, servings) pairs; unknown dishes are
+ignored.
+* @param allow_transfers Whether leftover stock may be moved between
+stations instead of buying more.
+* @return: The purchases and transfers, and what the purchases cost.
+*/
+StationManager::ReplenishmentPlan StationManager::planReplenishment(const std::vector<std::pair<std::string, int>>& forecast, bool allow_transfers) const {
+    RecipeCatalog& catalog = RecipeCatalog::instance();
+    std::vector<int> demand(catalog.dishCount(), 0);
+
+    for (size_t i = 0; i < forecast.size(); i++) {
+        RecipeCatalog::DishId id = catalog.findDishId(forecast[i].first);
+        if (id < 0 || forecast[i].second <= 0)
+            continue;
+
+        //A dish registered since dishCount was read
+        if (static_cast<size_t>(id) >= demand.size())
+            demand.resize(id + 1, 0);
+        demand[id] += forecast[i].second;
+    }
+
+    //Each station claims all the demand of its dishes, so a dish is planned at the first station that has it and no later one
+    std::vector<std::string> station_names;
+    std::vector<KitchenStation::StockForecast> stocks;
+    for (Node<KitchenStation*>* cur = getHeadNode(); cur != nullptr; cur = cur->getNext()) {
+        station_names.push_back(cur->getItem()->getName());
+        stocks.push_back(cur->getItem()->forecastStock(demand));
+    }
+
+    //Grouping every slot by ingredient: what falls short, what is left over and the lowest known price
+    std::unordered_map<std::string, int> ingredient_ids;
+    std::vector<const std::string*> ingredients;
+    std::vector<double> lowest_prices;
+    std::vector<std::vector<std::pair<int, int>>> shorts; //(station, slot) per ingredient
+    std::vector<std::vector<std::pair<int, int>>> spares; //(station, quantity) per ingredient
+
+    for (size_t s = 0; s < stocks.size(); s++) {
+        const KitchenStation::StockForecast& stock = stocks[s];
+
+        for (size_t k = 0; k < stock.balances.size(); k++) {
+            auto found = ingredient_ids.emplace(stock.ingredients[k], ingredients.size());
+            int id = found.first->second;
+
+            if (found.second) {
+                ingredients.push_back(&found.first->first);
+                lowest_prices.push_back(0.0);
+                shorts.emplace_back();
+                spares.emplace_back();
+            }
+
+            //A price of 0 means the station never learned one
+            double price = stock.prices[k];
+            if (price > 0 && (lowest_prices[id] == 0 || price < lowest_prices[id]))
+                lowest_prices[id] = price;
+
+            if (stock.balances[k] < 0)
+                shorts[id].emplace_back(s, k);
+            else if (stock.balances[k] > 0)
+                spares[id].emplace_back(s, stock.balances[k]);
+        }
+    }
+
+    ReplenishmentPlan plan;
+    for (size_t id = 0; id < ingredients.size(); id++) {
+        std::vector<std::pair<int, int>>& short_of = shorts[id];
+        std::vector<std::pair<int, int>>& spare = spares[id];
+        size_t next_spare = 0;
+
+        for (size_t i = 0; i < short_of.size(); i++) {
+            const KitchenStation::StockForecast& stock = stocks[short_of[i].first];
+            int slot = short_of[i].second;
+            int missing = -stock.balances[slot];
+
+            //Moving leftovers is free, so they are used up before anything is bought
+            while (allow_transfers && missing > 0 && next_spare < spare.size()) {
+                int moved = std::min(missing, spare[next_spare].second);
+
+                Transfer transfer;
+                transfer.from = station_names[spare[next_spare].first];
+                transfer.to = station_names[short_of[i].first];
+                transfer.ingredient = *ingredients[id];
+                transfer.quantity = moved;
+                plan.transfers.push_back(transfer);
+
+                missing -= moved;
+                spare[next_spare].second -= moved;
+                if (spare[next_spare].second == 0)
+                    next_spare++;
+            }
+
+            if (missing == 0)
+                continue;
+
+            Purchase purchase;
+            purchase.station = station_names[short_of[i].first];
+            purchase.ingredient = Ingredient(*ingredients[id], missing, stock.required[slot], lowest_prices[id]);
+            plan.purchases.push_back(purchase);
+            plan.cost += missing * lowest_prices[id];
+        }
+    }
+
+    return plan;
+}
+
+/**
+* Switches to concurrent execution: every station gets its own
+worker thread with an inbound order queue.
+* @post: Stations added later also get a worker, until stopWorkers.
+*/
+void StationManager::startWorkers() {
+    if (workers_running_)
+        return;
+
+    workers_running_ = true;
+    for (Node<KitchenStation*>* cur = getHeadNode(); cur != nullptr; cur = cur->getNext())
+        workers_[cur->getItem()] = std::unique_ptr<StationWorker>(new StationWorker(cur->getItem(), &dispatcher_));
+}
+
+/**
+* Switches back to synchronous execution.
+* @post: Every queued order is finished and all workers are joined.
+*/
+void StationManager::stopWorkers() {
+    //Each worker drains its queue before joining
+    workers_.clear();
+    workers_running_ = false;
+
+    snapshotIfDue();
+}
+
+/**
+* Checks whether stations are running on worker threads.
+* @return: True between startWorkers and stopWorkers; false otherwise.
+*/
+bool StationManager::workersRunning() const {
+    return workers_running_;
+}
+
+/**
+* Routes an order to a specific station without waiting for it.
+* @param station_name A string representing the station's name.
+* @param dish_name A string representing the name of the dish.
+* @post: With workers running, the order is queued on the station's
+worker; otherwise it is prepared immediately.
+* @return: A future that becomes true if the dish was prepared and
+false otherwise (including when the station does not exist).
+*/
+std::future<bool> StationManager::prepareDishAtStationAsync(const std::string& station_name, const std::string& dish_name) {
+    return prepareDishAtStationAsync(findStation(station_name), RecipeCatalog::instance().findDishId(dish_name));
+}
+
+/**
+* Routes an order to a specific station without waiting for it.
+* @param station_name A string representing the station's name.
+* @param dish_id The dish's id, from findDishId.
+* @return: As prepareDishAtStationAsync by name.
+*/
+std::future<bool> StationManager::prepareDishAtStationAsync(const std::string& station_name, RecipeCatalog::DishId dish_id) {
+    return prepareDishAtStationAsync(findStation(station_name), dish_id);
+}
+
+/**
+* Routes an order to a station already looked up, skipping the search
+by name.
+* @param station A station of this manager, from findStation or
+capableStations, that has not been removed or merged away since; or
+nullptr.
+* @param dish_id The dish's id, from findDishId.
+* @return: As prepareDishAtStationAsync by name; false if station is
+nullptr.
+*/
+std::future<bool> StationManager::prepareDishAtStationAsync(KitchenStation* station, RecipeCatalog::DishId dish_id) {
+    if (station != nullptr && workers_running_)
+        return workers_[station]->submit(dish_id);
+
+    //No worker to hand the order to, so the result is ready right away
+    std::promise<bool> result;
+    result.set_value(station != nullptr && station->prepareDish(dish_id));
+    return result.get_future();
+}
+
+/**
+* Sends an order to the least-loaded station that can complete it.
+* @param dish_name A string representing the name of the dish.
+* @post: With workers running, the order is queued on the capable
+station whose worker has the shortest backlog; idle workers may
+later steal it if their station can make it too. Otherwise the
+first capable station prepares it immediately.
+* @return: A future that becomes true if the dish was prepared and
+false otherwise (including when no station can complete it).
+*/
+std::future<bool> StationManager::dispatchOrder(const std::string& dish_name) {
+    return dispatchOrder(RecipeCatalog::instance().findDishId(dish_name));
+}
+
+/**
+* Sends an order to the least-loaded station that can complete it.
+* @param dish_id The dish's id, from findDishId.
+* @return: As dispatchOrder by name.
+*/
+std::future<bool> StationManager::dispatchOrder(RecipeCatalog::DishId dish_id) {
+    StationWorker* target = nullptr;
+    int target_load = 0;
+    std::vector<KitchenStation*> stations = capableStations(dish_id);
+
+    for (size_t i = 0; i < stations.size(); i++) {
+        KitchenStation* station = stations[i];
+
+        if (!workers_running_)
+            return prepareDishAtStationAsync(station, dish_id);
+
+        //Keeping the capable worker with the shortest backlog
+        StationWorker* worker = workers_[station].get();
+        int load = worker->load();
+        if (target == nullptr || load < target_load) {
+            target = worker;
+            target_load = load;
+        }
+    }
+
+    if (target != nullptr)
+        return target->submit(dish_id);
+
+    std::promise<bool> result;
+    result.set_value(false);
+    return result.get_future();
+}
+
+/**
+* Summarizes the latency of every order finished by the workers.
+* @return: Latency percentiles and how many orders were stolen.
+*/
+OrderDispatcher::LatencyReport StationManager::orderLatencyReport() const {
+    return dispatcher_.latencyReport();
+}
+
+/**
+* Starts recording every change to the stations in a binary event log.
+* @param log_path The log file; events are appended to it.
+* @param snapshot_path Where snapshots of the stations are written.
+* @param snapshot_interval Take a snapshot after this many events, at the
+end of the next operation made while workers are stopped; 0 to only take
+them through writeSnapshot.
+* @post: A first snapshot is written, so the snapshot plus the log
+describe the stations from now on.
+* @return: True if logging started; false if it is already running,
+workers are running, or a file could not be written.
+*/
+bool StationManager::startEventLog(const std::string& log_path, const std::string& snapshot_path, long snapshot_interval) {
+    if (event_log_ || workers_running_)
+        return false;
+
+    event_log_.reset(new InventoryLog(log_path));
+    snapshot_path_ = snapshot_path;
+    snapshot_interval_ = snapshot_interval;
+
+    if (!event_log_->isOpen() || !writeSnapshot()) {
+        event_log_.reset();
+        return false;
+    }
+
+    for (Node<KitchenStation*>* cur = getHeadNode(); cur != nullptr; cur = cur->getNext())
+        watchStock(cur->getItem());
+
+    return true;
+}
+
+/**
+* Stops recording events.
+* @post: Every event recorded so far is written to the log file.
+*/
+void StationManager::stopEventLog() {
+    if (!event_log_)
+        return;
+
+    //Once a station's listener is cleared, none of its calls is still running
+    for (Node<KitchenStation*>* cur = getHeadNode(); cur != nullptr; cur = cur->getNext())
+        cur->getItem()->setStockListener(nullptr);
+
+    event_log_.reset();
+}
+
+/**
+* Writes a snapshot of every station, with the log offset it covers.
+Must be called while no other thread uses the stations.
+* @return: True if the snapshot was written; false if no event log is
+running, workers are running, or the file could not be written.
+*/
+bool StationManager::writeSnapshot() {
+    if (!event_log_ || workers_running_)
+        return false;
+
+    //The snapshot covers every event written up to this offset
+    InventoryLog::Writer snapshot;
+    snapshot.putLong(event_log_->flush());
+    snapshot.putInt(getLength());
+
+    for (Node<KitchenStation*>* cur = getHeadNode(); cur != nullptr; cur = cur->getNext()) {
+        KitchenStation* station = cur->getItem();
+        snapshot.putStation(station->getName(), station->getDishes(), station->getIngredientsStock());
+    }
+
+    if (!InventoryLog::writeFileAtomically(snapshot_path_, snapshot.bytes))
+        return false;
+
+    events_since_snapshot_ = 0;
+    return true;
+}
+
+/**
+* Rebuilds the stations from a snapshot and the tail of the log that
+follows it.
+* @param snapshot_path A snapshot written by startEventLog or
+writeSnapshot.
+* @param log_path The log the snapshot belongs to.
+* @post: The stations are those of the snapshot with every later event
+applied. A record cut short by a crash ends the replay.
+* @return: True if the stations were rebuilt; false if the manager is not
+empty, an event log is running, or the snapshot is unreadable.
+*/
+bool StationManager::recover(const std::string& snapshot_path, const std::string& log_path) {
+    std::vector<char> bytes;
+
+    if (!isEmpty() || event_log_ || !InventoryLog::readFile(snapshot_path, bytes))
+        return false;
+
+    InventoryLog::Reader snapshot(bytes.data(), bytes.size());
+    long long offset;
+    int count;
+
+    if (!snapshot.getLong(offset) || !snapshot.getInt(count))
+        return false;
+
+    //Decoding every station before adding any, so a bad snapshot changes nothing
+    std::vector<KitchenStation*> stations;
+    if (!readStations(snapshot, count, stations))
+        return false;
+
+    addStations(stations);
+
+    //A missing log just means nothing happened after the snapshot
+    InventoryLog::readEvents(log_path, offset, [this](InventoryLog::EventType type, InventoryLog::Reader& body) {
+        replayEvent(type, body);
+    });
+
+    return true;
+}
+
+/**
+* Loads a kitchen from a stations file and a stock file, reading both a
+line at a time.
+* @param stations_path Lines of "station" or "station,dish,prep
+time,price,cuisine" followed by "name,quantity,required quantity,price"
+per ingredient.
+* @param stock_path Lines of "station,ingredient,quantity,required
+quantity,price".
+* @post: Every station of the files is added with its dishes and stock.
+* @return: True if the kitchen was loaded; false if the manager is not
+empty, a file is unreadable or a line is malformed, in which case
+nothing is added.
+*/
+bool StationManager::loadFromFile(const std::string& stations_path, const std::string& stock_path) {
+    if (!isEmpty())
+        return false;
+
+    //Building every station before adding any, so a bad file changes nothing
+    std::vector<KitchenStation*> stations;
+    std::unordered_map<std::string, KitchenStation*> by_name;
+    std::string name;
+    KitchenStation* station = nullptr;
+
+    //Lines of one station usually follow each other, so the last station is checked before the map
+    auto lookUp = [&](std::string_view station_name, bool create) {
+        if (station != nullptr && name == station_name)
+            return station;
+
+        name.assign(station_name);
+        auto found = by_name.find(name);
+
+        if (found != by_name.end())
+            station = found->second;
+        else if (create) {
+            station = new KitchenStation(name);
+            stations.push_back(station);
+            by_name.emplace(name, station);
+        }
+        else
+            station = nullptr;
+
+        return station;
+    };
+
+    bool loaded = LayoutFile::readRecords(stations_path, [&](const LayoutFile::Fields& fields) {
+        if (fields[0].empty())
+            return false;
+
+        KitchenStation* target = lookUp(fields[0], true);
+        if (fields.size() == 1)
+            return true;
+
+        int prep_time;
+        double price;
+        Dish::CuisineType cuisine;
+
+        if (fields.size() < 5 || (fields.size() - 5) % 4 != 0 || !LayoutFile::toInt(fields[2], prep_time)
+            || !LayoutFile::toDouble(fields[3], price) || !LayoutFile::toCuisine(fields[4], cuisine))
+            return false;
+
+        std::vector<Ingredient> ingredients;
+        for (size_t i = 5; i < fields.size(); i += 4) {
+            Ingredient ingredient;
+            ingredient.name.assign(fields[i]);
+
+            if (!LayoutFile::toInt(fields[i + 1], ingredient.quantity) || !LayoutFile::toInt(fields[i + 2], ingredient.required_quantity)
+                || !LayoutFile::toDouble(fields[i + 3], ingredient.price))
+                return false;
+
+            ingredients.push_back(ingredient);
+        }
+
+        Dish* dish = new Dish(std::string(fields[1]), ingredients, prep_time, price, cuisine);
+        if (!target->assignDishToStation(dish))
+            delete dish;
+
+        return true;
+    });
+
+    loaded = loaded && LayoutFile::readRecords(stock_path, [&](const LayoutFile::Fields& fields) {
+        Ingredient ingredient;
+
+        if (fields.size() != 5 || !LayoutFile::toInt(fields[2], ingredient.quantity) || ingredient.quantity < 0
+            || !LayoutFile::toInt(fields[3], ingredient.required_quantity) || !LayoutFile::toDouble(fields[4], ingredient.price))
+            return false;
+
+        //Stock may only go to stations of the stations file
+        KitchenStation* target = lookUp(fields[0], false);
+        if (target == nullptr)
+            return false;
+
+        if (ingredient.quantity > 0) {
+            ingredient.name.assign(fields[1]);
+            target->replenishStationIngredients(ingredient);
+        }
+
+        return true;
+    });
+
+    if (!loaded) {
+        for (size_t i = 0; i < stations.size(); i++)
+            delete stations[i];
+        return false;
+    }
+
+    addStations(stations);
+    return true;
+}
+
+/**
+* Saves every station in the format of loadFromFile.
+* @param stations_path Where the stations and their dishes are written.
+* @param stock_path Where the in-stock ingredients are written.
+* @return: True if both files were written; false if a name cannot be
+written as a field or a file could not be written.
+*/
+bool StationManager::saveToFile(const std::string& stations_path, const std::string& stock_path) const {
+    std::string stations_text;
+    std::string stock_text;
+    std::string line;
+
+    for (Node<KitchenStation*>* cur = getHeadNode(); cur != nullptr; cur = cur->getNext()) {
+        KitchenStation* station = cur->getItem();
+        std::string station_name = station->getName();
+        std::vector<const Dish*> dishes = station->getDishes();
+        std::vector<Ingredient> stock = station->getIngredientsStock();
+
+        if (!LayoutFile::isWritable(station_name))
+            return false;
+
+        //A station without dishes still gets a line so it is loaded back
+        if (dishes.empty())
+            stations_text += station_name + "\n";
+
+        for (size_t i = 0; i < dishes.size(); i++) {
+            std::vector<Ingredient> ingredients = dishes[i]->getIngredients();
+
+            if (!LayoutFile::isWritable(dishes[i]->getName()))
+                return false;
+
+            line.clear();
+            LayoutFile::putField(line, station_name);
+            LayoutFile::putField(line, dishes[i]->getName());
+            LayoutFile::putField(line, dishes[i]->getPrepTime());
+            LayoutFile::putField(line, dishes[i]->getPrice());
+            LayoutFile::putField(line, dishes[i]->getCuisineType());
+
+            for (size_t j = 0; j < ingredients.size(); j++) {
+                if (!LayoutFile::isWritable(ingredients[j].name))
+                    return false;
+
+                LayoutFile::putField(line, ingredients[j].name);
+                LayoutFile::putField(line, ingredients[j].quantity);
+                LayoutFile::putField(line, ingredients[j].required_quantity);
+                LayoutFile::putField(line, ingredients[j].price);
+            }
+
+            stations_text += line;
+            stations_text += '\n';
+        }
+
+        for (size_t i = 0; i < stock.size(); i++) {
+            if (!LayoutFile::isWritable(stock[i].name))
+                return false;
+
+            line.clear();
+            LayoutFile::putField(line, station_name);
+            LayoutFile::putField(line, stock[i].name);
+            LayoutFile::putField(line, stock[i].quantity);
+            LayoutFile::putField(line, stock[i].required_quantity);
+            LayoutFile::putField(line, stock[i].price);
+
+            stock_text += line;
+            stock_text += '\n';
+        }
+    }
+
+    return InventoryLog::writeFileAtomically(stations_path, std::vector<char>(stations_text.begin(), stations_text.end()))
+        && InventoryLog::writeFileAtomically(stock_path, std::vector<char>(stock_text.begin(), stock_text.end()));
+}
+
+/**
+* Loads a kitchen saved by saveToBinaryFile.
+* @param path The binary layout file.
+* @post: Every station of the file is added with its dishes and stock.
+* @return: True if the kitchen was loaded; false if the manager is not
+empty or the file is unreadable, in which case nothing is added.
+*/
+bool StationManager::loadFromBinaryFile(const std::string& path) {
+    std::vector<char> bytes;
+
+    if (!isEmpty() || !InventoryLog::readFile(path, bytes))
+        return false;
+
+    InventoryLog::Reader layout(bytes.data(), bytes.size());
+    int magic;
+    int count;
+
+    if (!layout.getInt(magic) || magic != LAYOUT_MAGIC || !layout.getInt(count))
+        return false;
+
+    std::vector<KitchenStation*> stations;
+    if (!readStations(layout, count, stations))
+        return false;
+
+    addStations(stations);
+    return true;
+}
+
+/**
+* Saves every station, its dishes and its stock in one binary file.
+* @param path The file to write.
+* @return: True if the file was written; false otherwise.
+*/
+bool StationManager::saveToBinaryFile(const std::string& path) const {
+    InventoryLog::Writer layout;
+    layout.putInt(LAYOUT_MAGIC);
+    layout.putInt(getLength());
+
+    for (Node<KitchenStation*>* cur = getHeadNode(); cur != nullptr; cur = cur->getNext()) {
+        KitchenStation* station = cur->getItem();
+        layout.putStation(station->getName(), station->getDishes(), station->getIngredientsStock());
+    }
+
+    return InventoryLog::writeFileAtomically(path, layout.bytes);
+}
+
+/**
+* Starts writing the metrics of the manager and every station to a
+Prometheus textfile-collector file.
+* @param path The file to write.
+* @param interval How often the file is rewritten.
+* @post: A background thread writes metricsText to path right away and
+then once per interval, replacing the file atomically.
+* @return: True if exporting started; false if it is already running.
+*/
+bool StationManager::startMetricsExport(const std::string& path, std::chrono::milliseconds interval) {
+    if (metrics_exporter_)
+        return false;
+
+    metrics_exporter_.reset(new MetricsExporter(path, interval, [this] { return metricsText(); }));
+    return true;
+}
+
+/**
+* Stops exporting metrics.
+* @post: The file is written one last time.
+*/
+void StationManager::stopMetricsExport() {
+    metrics_exporter_.reset();
+}
+
+/**
+* Renders the metrics of the manager and every station in the
+Prometheus text format.
+* @return: The exposition text.
+*/
+std::string StationManager::metricsText() const {
+    std::ostringstream text;
+
+    //Writes one histogram series; labels end with a comma when not empty
+    auto histogram = [&text](const std::string& name, const std::string& labels, const Metrics::Histogram& latency) {
+        long cumulative = 0;
+
+        for (int b = 0; b < Metrics::BUCKET_COUNT; b++) {
+            cumulative += latency.buckets[b];
+            text << name << "_bucket{" << labels << "le=\"";
+            if (b < Metrics::BUCKET_COUNT - 1)
+                text << Metrics::BUCKET_BOUNDS_NS[b] / 1e9;
+            else
+                text << "+Inf";
+            text << "\"} " << cumulative << "\n";
+        }
+
+        //The labels without their trailing comma
+        std::string series = labels.empty() ? "" : "{" + labels.substr(0, labels.size() - 1) + "}";
+        text << name << "_sum" << series << " " << latency.sum_seconds << "\n";
+        text << name << "_count" << series << " " << latency.count << "\n";
+    };
+
+    //Stations unlinked after the copy below are not freed until the render is done
+    std::shared_lock<std::shared_mutex> render_lock(render_mutex_);
+    std::vector<KitchenStation*> stations;
+    std::vector<std::string> names;
+
+    //Holding the list still only while copying it, so the manager is never blocked by the render
+    {
+        std::lock_guard<std::mutex> lock(list_mutex_);
+        for (Node<KitchenStation*>* cur = getHeadNode(); cur != nullptr; cur = cur->getNext())
+            stations.push_back(cur->getItem());
+    }
+
+    for (size_t i = 0; i < stations.size(); i++)
+        names.push_back(Metrics::escapeLabel(stations[i]->getName()));
+
+    text << "# HELP bistro_stations Kitchen stations in the manager.\n";
+    text << "# TYPE bistro_stations gauge\n";
+    text << "bistro_stations " << stations.size() << "\n";
+
+    {
+        std::lock_guard<std::mutex> route_lock(route_mutex_);
+        text << "# HELP bistro_route_cache_entries Dishes with a cached list of capable stations.\n";
+        text << "# TYPE bistro_route_cache_entries gauge\n";
+        text << "bistro_route_cache_entries " << route_cache_.size() << "\n";
+    }
+
+    OrderDispatcher::LatencyReport report = dispatcher_.latencyReport();
+    text << "# HELP bistro_worker_orders_total Orders finished by station workers.\n";
+    text << "# TYPE bistro_worker_orders_total counter\n";
+    text << "bistro_worker_orders_total " << report.orders << "\n";
+    text << "# HELP bistro_worker_orders_stolen_total Orders finished by a worker that stole them.\n";
+    text << "# TYPE bistro_worker_orders_stolen_total counter\n";
+    text << "bistro_worker_orders_stolen_total " << report.stolen << "\n";
+    text << "# HELP bistro_worker_order_latency_seconds Latency percentiles of orders finished by station workers.\n";
+    text << "# TYPE bistro_worker_order_latency_seconds gauge\n";
+    text << "bistro_worker_order_latency_seconds{quantile=\"0.5\"} " << report.p50_us / 1e6 << "\n";
+    text << "bistro_worker_order_latency_seconds{quantile=\"0.9\"} " << report.p90_us / 1e6 << "\n";
+    text << "bistro_worker_order_latency_seconds{quantile=\"0.99\"} " << report.p99_us / 1e6 << "\n";
+    text << "bistro_worker_order_latency_seconds{quantile=\"1\"} " << report.max_us / 1e6 << "\n";
+
+    text << "# HELP bistro_manager_operation_duration_seconds Latency of station manager operations.\n";
+    text << "# TYPE bistro_manager_operation_duration_seconds histogram\n";
+    for (int o = 0; o < Metrics::OPERATION_COUNT; o++) {
+        Metrics::Operation operation = static_cast<Metrics::Operation>(o);
+        Metrics::Histogram latency = metrics_.latency(operation);
+
+        if (latency.count > 0)
+            histogram("bistro_manager_operation_duration_seconds", "operation=\"" + std::string(Metrics::operationName(operation)) + "\",", latency);
+    }
+
+    for (int c = 0; c < Metrics::COUNTER_COUNT; c++) {
+        Metrics::Counter counter = static_cast<Metrics::Counter>(c);
+        std::string name = std::string("bistro_station_") + Metrics::counterName(counter);
+
+        text << "# HELP " << name << " " << Metrics::counterHelp(counter) << "\n";
+        text << "# TYPE " << name << " counter\n";
+        for (size_t i = 0; i < stations.size(); i++)
+            text << name << "{station=\"" << names[i] << "\"} " << stations[i]->metrics().total(counter) << "\n";
+    }
+
+    text << "# HELP bistro_station_order_checks_failed_by_ingredient_total Failed canCompleteOrder calls by ingredient that fell short.\n";
+    text << "# TYPE bistro_station_order_checks_failed_by_ingredient_total counter\n";
+    for (size_t i = 0; i < stations.size(); i++) {
+        std::vector<std::pair<std::string, long>> missing = stations[i]->metrics().missing();
+
+        for (size_t j = 0; j < missing.size(); j++) {
+            text << "bistro_station_order_checks_failed_by_ingredient_total{station=\"" << names[i]
+                 << "\",ingredient=\"" << Metrics::escapeLabel(missing[j].first) << "\"} " << missing[j].second << "\n";
+        }
+    }
+
+    text << "# HELP bistro_station_servings_remaining Servings each dish can still make from the unreserved stock.\n";
+    text << "# TYPE bistro_station_servings_remaining gauge\n";
+    for (size_t i = 0; i < stations.size(); i++) {
+        std::vector<std::pair<std::string, int>> board = stations[i]->getServingsBoard();
+
+        for (size_t j = 0; j < board.size(); j++) {
+            text << "bistro_station_servings_remaining{station=\"" << names[i]
+                 << "\",dish=\"" << Metrics::escapeLabel(board[j].first) << "\"} " << board[j].second << "\n";
+        }
+    }
+
+    text << "# HELP bistro_station_stock_quantity Quantity of each ingredient in stock.\n";
+    text << "# TYPE bistro_station_stock_quantity gauge\n";
+    for (size_t i = 0; i < stations.size(); i++) {
+        std::vector<Ingredient> stock = stations[i]->getIngredientsStock();
+
+        for (size_t j = 0; j < stock.size(); j++) {
+            text << "bistro_station_stock_quantity{station=\"" << names[i]
+                 << "\",ingredient=\"" << Metrics::escapeLabel(stock[j].name) << "\"} " << stock[j].quantity << "\n";
+        }
+    }
+
+    text << "# HELP bistro_station_operation_duration_seconds Latency of kitchen station operations.\n";
+    text << "# TYPE bistro_station_operation_duration_seconds histogram\n";
+    for (size_t i = 0; i < stations.size(); i++) {
+        for (int o = 0; o < Metrics::OPERATION_COUNT; o++) {
+            Metrics::Operation operation = static_cast<Metrics::Operation>(o);
+            Metrics::Histogram latency = stations[i]->metrics().latency(operation);
+
+            if (latency.count > 0)
+                histogram("bistro_station_operation_duration_seconds", "station=\"" + names[i] + "\",operation=\"" + Metrics::operationName(operation) + "\",", latency);
+        }
+    }
+
+    return text.str();
+}
+
+/**
+* Retrieves the latency histograms of the manager's own operations.
+* @return: The manager's metrics.
+*/
+const Metrics& StationManager::metrics() const {
+    return metrics_;
+}
+
+/**
+* Appends an event to the log, if one is running.
+* @param type The kind of event.
+* @param body The encoded event.
+*/
+void StationManager::logEvent(InventoryLog::EventType type, const InventoryLog::Writer& body) {
+    if (!event_log_)
+        return;
+
+    event_log_->append(type, body);
+    events_since_snapshot_++;
+}
+
+/**
+* Makes a station record its own changes in the event log.
+* @param station A station in the list.
+*/
+void StationManager::watchStock(KitchenStation* station) {
+    station->setStockListener([this](KitchenStation* changed, const KitchenStation::StockEvent& event) {
+        InventoryLog::Writer body;
+        body.putString(changed->getName());
+
+        if (event.type == KitchenStation::StockEvent::ASSIGNED) {
+            body.putDish(*event.dish);
+            logEvent(InventoryLog::ASSIGN_DISH, body);
+        }
+        else if (event.type == KitchenStation::StockEvent::REPLENISHED) {
+            body.putIngredient(*event.ingredient);
+            logEvent(InventoryLog::REPLENISH, body);
+        }
+        else {
+            body.putString(*event.dish_name);
+            body.putInt(event.servings);
+            logEvent(InventoryLog::PREPARE, body);
+        }
+    });
+}
+
+/**
+* Writes a snapshot if snapshot_interval_ events were logged since the
+last one and workers are stopped.
+*/
+void StationManager::snapshotIfDue() {
+    if (event_log_ && !workers_running_ && snapshot_interval_ > 0 && events_since_snapshot_ >= snapshot_interval_)
+        writeSnapshot();
+}
+
+/**
+* Applies one logged event to the stations.
+* @param type The kind of event.
+* @param body The encoded event.
+*/
+void StationManager::replayEvent(InventoryLog::EventType type, InventoryLog::Reader& body) {
+    std::string station_name, other_name;
+
+    if (type == InventoryLog::ADD_STATION) {
+        KitchenStation* station = readStation(body);
+        if (station != nullptr && !addStation(station))
+            delete station;
+        return;
+    }
+
+    if (!body.getString(station_name))
+        return;
+
+    if (type == InventoryLog::REMOVE_STATION)
+        removeStation(station_name);
+    else if (type == InventoryLog::MERGE_STATIONS) {
+        if (body.getString(other_name))
+            mergeStations(station_name, other_name);
+    }
+    else if (type == InventoryLog::RENAME_STATION) {
+        KitchenStation* station = findStation(station_name);
+
+        if (station != nullptr && body.getString(other_name))
+            station->setName(other_name);
+    }
+    else if (type == InventoryLog::ASSIGN_DISH) {
+        KitchenStation* station = findStation(station_name);
+        Dish* dish = body.getDish();
+
+        if (dish != nullptr && (station == nullptr || !station->assignDishToStation(dish)))
+            delete dish;
+    }
+    else if (type == InventoryLog::REPLENISH) {
+        Ingredient ingredient;
+        if (body.getIngredient(ingredient))
+            replenishIngredientAtStation(station_name, ingredient);
+    }
+    else if (type == InventoryLog::PREPARE) {
+        std::string dish_name;
+        int servings;
+
+        //Replaying the servings as one batch order deducts exactly what was used
+        if (body.getString(dish_name) && body.getInt(servings))
+            prepareBatch(station_name, {std::make_pair(dish_name, servings)});
+    }
+}
+
+/**
+* Builds a station from the encoding of Writer::putStation.
+* @param body The encoded station.
+* @return: A new station owned by the caller, or nullptr if the encoding
+is cut short.
+*/
+KitchenStation* StationManager::readStation(InventoryLog::Reader& body) {
+    std::string name;
+    int count;
+
+    if (!body.getString(name) || !body.getInt(count))
+        return nullptr;
+
+    KitchenStation* station = new KitchenStation(name);
+
+    for (int i = 0; i < count; i++) {
+        Dish* dish = body.getDish();
+
+        if (dish == nullptr) {
+            delete station;
+            return nullptr;
+        }
+
+        if (!station->assignDishToStation(dish))
+            delete dish;
+    }
+
+    if (!body.getInt(count)) {
+        delete station;
+        return nullptr;
+    }
+
+    for (int i = 0; i < count; i++) {
+        Ingredient ingredient;
+
+        if (!body.getIngredient(ingredient)) {
+            delete station;
+            return nullptr;
+        }
+
+        station->replenishStationIngredients(ingredient);
+    }
+
+    return station;
+}
+
+/**
+* Stops the worker of a station, if any, after its queue drains.
+* @param station A pointer to the KitchenStation.
+*/
+void StationManager::stopWorker(KitchenStation* station) {
+    workers_.erase(station);
+}
+
+/**
+* Runs a check over every station, split into chunks run in parallel
+when parallel checks are on.
+* @param stations The stations to check.
+* @param check Called with each chunk's [begin, end) range of stations.
+*/
+void StationManager::forEachStationChunk(const std::vector<KitchenStation*>& stations, const std::function<void(int, int)>& check) {
+    int count = stations.size();
+    int chunks = (count + PARALLEL_CHECK_CHUNK - 1) / PARALLEL_CHECK_CHUNK;
+    std::shared_ptr<ThreadPool> pool = std::atomic_load(&check_pool_);
+
+    //One chunk per pool thread plus one for the calling thread
+    if (pool)
+        chunks = std::min(chunks, pool->size() + 1);
+
+    if (!pool || chunks <= 1) {
+        check(0, count);
+        return;
+    }
+
+    pool->parallelFor(chunks, [&](int chunk) {
+        check((long long)count * chunk / chunks, (long long)count * (chunk + 1) / chunks);
+    });
+}
+
+/**
+* Builds stations from consecutive encodings of Writer::putStation.
+* @param body The encoded stations.
+* @param count The number of stations to read.
+* @param stations Receives the new stations, owned by the caller.
+* @return: True if every station was read; false if the encoding is cut
+short, in which case stations is left empty.
+*/
+bool StationManager::readStations(InventoryLog::Reader& body, int count, std::vector<KitchenStation*>& stations) {
+    for (int i = 0; i < count; i++) {
+        KitchenStation* station = readStation(body);
+
+        if (station == nullptr) {
+            for (size_t j = 0; j < stations.size(); j++)
+                delete stations[j];
+            stations.clear();
+            return false;
+        }
+
+        stations.push_back(station);
+    }
+
+    return true;
+}
+
+/**
+* Adds stations built for this manager.
+* @param stations New stations; any whose name is taken is deleted.
+*/
+void StationManager::addStations(const std::vector<KitchenStation*>& stations) {
+    for (size_t i = 0; i < stations.size(); i++) {
+        if (!addStation(stations[i]))
+            delete stations[i];
+    }
+}
+
+/**
+* Returns the node holding the station that follows prev_ptr.
+* @param prev_ptr A node of the list, or nullptr for the head.
+* @return: The node after prev_ptr, or the head node if prev_ptr is
+nullptr.
+*/
+Node<KitchenStation*>* StationManager::nodeAfter(Node<KitchenStation*>* prev_ptr) const {
+    return (prev_ptr == nullptr) ? getHeadNode() : prev_ptr->getNext();
+}
+
+/**
+* Unlinks a station from the list and from the name index without
+deallocating the station.
+* @param station_name A string representing the station's name.
+* @post: No metricsText render still reads the station, so the caller
+may free it.
+* @return: The unlinked station if found; nullptr otherwise.
+*/
+KitchenStation* StationManager::unlinkStation(const std::string& station_name) {
+    auto found = station_index_.find(station_name);
+
+    if (found == station_index_.end())
+        return nullptr;
+
+    Node<KitchenStation*>* prev = found->second;
+    Node<KitchenStation*>* node = nodeAfter(prev);
+    KitchenStation* station = node->getItem();
+
+    //The successor now follows the station's predecessor
+    if (node->getNext() != nullptr)
+        station_index_[node->getNext()->getItem()->getName()] = prev;
+
+    //The run of the station's count now starts at its successor, if that has the same count
+    long count = access_counts_[station];
+    if (counts_sorted_ && count_leaders_[count] == station) {
+        Node<KitchenStation*>* next = node->getNext();
+
+        if (next != nullptr && access_counts_[next->getItem()] == count)
+            count_leaders_[count] = next->getItem();
+        else
+            count_leaders_.erase(count);
+    }
+
+    station_index_.erase(found);
+    access_counts_.erase(station);
+    station->setRenameListener(nullptr);
+    {
+        std::lock_guard<std::mutex> lock(list_mutex_);
+        removeAfter(prev);
+    }
+    forgetRoutes(station);
+
+    //A render that copied the list before the removal may still read the station; the caller frees it after this
+    std::lock_guard<std::shared_mutex> wait(render_mutex_);
+    return station;
+}
+
+/**
+* Moves a station forward in the list without allocating.
+* @param prev The node preceding the station, or nullptr for the head.
+* @param new_prev The node the station should follow, or nullptr for the
+front; must come before the station in the list.
+* @post: The station follows new_prev and station_index_ is current.
+*/
+void StationManager::relinkStation(Node<KitchenStation*>* prev, Node<KitchenStation*>* new_prev) {
+    if (prev == new_prev)
+        return;
+
+    Node<KitchenStation*>* node = nodeAfter(prev);
+    Node<KitchenStation*>* next = node->getNext();
+    Node<KitchenStation*>* displaced = nodeAfter(new_prev);
+
+    //The successor now follows the station's old predecessor, and the station precedes the one it displaces
+    if (next != nullptr)
+        station_index_[next->getItem()->getName()] = prev;
+    station_index_[displaced->getItem()->getName()] = node;
+    station_index_[node->getItem()->getName()] = new_prev;
+
+    //Relinking the node itself so no node is allocated or freed
+    std::lock_guard<std::mutex> lock(list_mutex_);
+    spliceAfter(new_prev, extractAfter(prev));
+}
+
+/**
+* Counts a lookup of a station and reorders the list according to the
+access policy.
+* @param prev The node preceding the station, or nullptr for the head.
+*/
+void StationManager::recordAccess(Node<KitchenStation*>* prev) {
+    Node<KitchenStation*>* node = nodeAfter(prev);
+    KitchenStation* station = node->getItem();
+    long count = ++access_counts_[station];
+
+    if (access_policy_ == MOVE_TO_FRONT)
+        relinkStation(prev, nullptr);
+    else if (access_policy_ == TRANSPOSE && prev != nullptr)
+        relinkStation(prev, station_index_[prev->getItem()->getName()]);
+    else if (access_policy_ == FREQUENCY_COUNT) {
+        auto leader = count_leaders_.find(count - 1);
+
+        //Sorting with the new count already in place
+        if (!counts_sorted_ || leader == count_leaders_.end()) {
+            sortByAccessCount();
+            return;
+        }
+
+        //Passing every station with the old count puts it behind every station accessed at least as often; ties keep their order
+        if (leader->second != station)
+            relinkStation(prev, station_index_[leader->second->getName()]);
+        else if (node->getNext() != nullptr && access_counts_[node->getNext()->getItem()] == count - 1)
+            leader->second = node->getNext()->getItem();
+        else
+            count_leaders_.erase(leader);
+
+        //Only the first station to reach a count leads its run
+        count_leaders_.emplace(count, station);
+    }
+}
+
+/**
+* Sorts the list by access count, most accessed first, keeping the
+order of stations with equal counts.
+* @post: count_leaders_ holds the front of every count's run and
+counts_sorted_ is set.
+*/
+void StationManager::sortByAccessCount() {
+    std::vector<KitchenStation*> stations;
+    for (Node<KitchenStation*>* cur = getHeadNode(); cur != nullptr; cur = cur->getNext())
+        stations.push_back(cur->getItem());
+
+    std::stable_sort(stations.begin(), stations.end(), [this](KitchenStation* a, KitchenStation* b) {
+        return access_counts_[a] > access_counts_[b];
+    });
+
+    //Moving the least accessed to the front first leaves the most accessed there
+    count_leaders_.clear();
+    for (size_t i = stations.size(); i-- > 0;) {
+        relinkStation(station_index_[stations[i]->getName()], nullptr);
+        count_leaders_[access_counts_[stations[i]]] = stations[i];
+    }
+
+    counts_sorted_ = true;
+}
+
+/**
+* Applies an availability flip reported by a station to the routing
+cache.
+* @param station The station whose answer changed.
+* @param dish_id The dish's id.
+* @param available Whether the station can complete the dish now.
+*/
+void StationManager::onAvailabilityChange(KitchenStation* station, RecipeCatalog::DishId dish_id, bool available) {
+    std::lock_guard<std::mutex> lock(route_mutex_);
+    route_generation_++;
+
+    auto found = route_cache_.find(dish_id);
+    if (found == route_cache_.end())
+        return;
+
+    std::vector<KitchenStation*>& stations = found->second;
+    auto position = std::find(stations.begin(), stations.end(), station);
+
+    if (available && position == stations.end())
+        stations.push_back(station);
+    else if (!available && position != stations.end())
+        stations.erase(position);
+}
+
+/**
+* Moves a station's entry in station_index_ to its new name.
+* @param station A station in the list that is being renamed.
+* @param new_name The name it is about to take.
+* @return: True if the rename may go ahead; false if another station has
+new_name.
+*/
+bool StationManager::onRename(KitchenStation* station, const std::string& new_name) {
+    std::string old_name = station->getName();
+
+    if (new_name == old_name)
+        return true;
+    if (station_index_.count(new_name) > 0)
+        return false;
+
+    auto found = station_index_.find(old_name);
+    Node<KitchenStation*>* prev = found->second;
+    station_index_.erase(found);
+    station_index_[new_name] = prev;
+
+    InventoryLog::Writer body;
+    body.putString(old_name);
+    body.putString(new_name);
+    logEvent(InventoryLog::RENAME_STATION, body);
+    return true;
+}
+
+/**
+* Detaches a station from the routing cache.
+* @param station A station that is leaving the list.
+* @post: The station no longer reports to the cache and appears in no
+entry.
+*/
+void StationManager::forgetRoutes(KitchenStation* station) {
+    station->setAvailabilityListener(nullptr);
+    std::vector<RecipeCatalog::DishId> dishes = station->getDishIds();
+
+    std::lock_guard<std::mutex> lock(route_mutex_);
+    route_generation_++;
+
+    //Only entries of the station's own dishes can mention it
+    for (size_t i = 0; i < dishes.size(); i++) {
+        auto found = route_cache_.find(dishes[i]);
+
+        if (found != route_cache_.end())
+            found->second.erase(std::remove(found->second.begin(), found->second.end(), station), found->second.end());
+    }
+}
+
+/**
+* Drops the cached entries of a station's dishes.
+* @param station A station joining the list.
+* @post: The entries are rebuilt on their next query, so they include
+the station if it can complete them.
+*/
+void StationManager::invalidateRoutes(KitchenStation* station) {
+    std::vector<RecipeCatalog::DishId> dishes = station->getDishIds();
+
+    std::lock_guard<std::mutex> lock(route_mutex_);
+    route_generation_++;
+
+    for (size_t i = 0; i < dishes.size(); i++)
+        route_cache_.erase(dishes[i]);
+}
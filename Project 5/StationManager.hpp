@@ -8,13 +8,79 @@
 #define STATIONMANAGER_HPP
 
 #include "KitchenStation.hpp"
+#include "StationWorker.hpp"
+#include "OrderDispatcher.hpp"
+#include "InventoryLog.hpp"
+#include "Metrics.hpp"
+#include "MetricsExporter.hpp"
+#include "ThreadPool.hpp"
+#include "LayoutFile.hpp"
 #include "LinkedList.hpp"
 #include "Dish.hpp"
 #include <string>
 #include <vector>
+#include <unordered_map>
+#include <unordered_set>
+#include <memory>
+#include <future>
+#include <mutex>
+#include <shared_mutex>
+#include <atomic>
+#include <chrono>
+#include <functional>
 
-class StationManager : public LinkedList<KitchenStation*> {
+//The list is inherited privately: stations are only linked and unlinked
+//through the operations below, which keep station_index_ current
+class StationManager : private LinkedList<KitchenStation*> {
     public:
+        using LinkedList<KitchenStation*>::isEmpty;
+        using LinkedList<KitchenStation*>::getLength;
+        using LinkedList<KitchenStation*>::getEntry;
+        using LinkedList<KitchenStation*>::getPointerTo;
+        using LinkedList<KitchenStation*>::getHeadNode;
+        using LinkedList<KitchenStation*>::getTailNode;
+
+        /**
+        * How the list reorganizes itself when a station is looked up by
+        name, so that stations used often sit near the front of every walk
+        over the list (routing checks stop at the first capable station).
+        */
+        enum AccessPolicy {
+            STATIC_ORDER, //never reorders; stations stay where they were added
+            MOVE_TO_FRONT, //the station looked up moves to the front
+            TRANSPOSE, //the station looked up swaps places with its predecessor
+            FREQUENCY_COUNT //stations stay sorted by access count, most accessed first
+        };
+
+        /**
+        * Ingredients to buy for a station. The ingredient's quantity is the
+        quantity to buy and its price the price per unit paid, so it can be
+        passed to replenishStationIngredients as it is.
+        */
+        struct Purchase {
+            std::string station; //name of the station the ingredient is for
+            Ingredient ingredient;
+        };
+
+        /**
+        * Ingredients one station can spare for another.
+        */
+        struct Transfer {
+            std::string from; //name of the station giving the ingredient
+            std::string to; //name of the station receiving it
+            std::string ingredient; //name of the ingredient
+            int quantity;
+        };
+
+        /**
+        * Outcome of planReplenishment.
+        */
+        struct ReplenishmentPlan {
+            std::vector<Purchase> purchases; //grouped by ingredient
+            std::vector<Transfer> transfers; //grouped by ingredient
+            double cost = 0.0; //total price of the purchases
+        };
+
         /**
         * Default Constructor
         * @post: Initializes an empty station manager.
@@ -30,9 +96,10 @@ class StationManager : public LinkedList<KitchenStation*> {
         /**
         * Adds a new station to the station manager.
         * @param station A pointer to a KitchenStation object.
-        * @post: Inserts the station into the linked list.
+        * @post: Inserts the station into the linked list and indexes it by
+        name.
         * @return: True if the station was successfully added; false
-        otherwise.
+        otherwise (nullptr or a station with the same name already exists).
         */
         bool addStation(KitchenStation* station);
 
@@ -53,23 +120,67 @@ class StationManager : public LinkedList<KitchenStation*> {
         */
         KitchenStation* findStation(const std::string& station_name);
 
+        /**
+        * Finds a station by name without counting an access, so the lookup
+        never reorders the list.
+        * @param station_name A string representing the station's name.
+        * @return: A pointer to the KitchenStation if found; nullptr
+        otherwise.
+        */
+        KitchenStation* peekStation(const std::string& station_name) const;
+
         /**
         * Moves a specified station to the front of the station manager
         list.
         * @param station_name A string representing the station's name.
         * @post: The station is moved to the front of the list if it
-        exists.
+        exists. Under FREQUENCY_COUNT the next lookup sorts the list by
+        access count again.
         * @return: True if the station was found and moved; false
         otherwise.
         */
         bool moveStationToFront(const std::string& station_name);
 
+        /**
+        * Selects how the list reorganizes itself on lookups.
+        * @param policy The policy. With any policy but STATIC_ORDER, every
+        findStation (and so every by-name operation) counts an access to the
+        station and reorders the list.
+        * @post: Switching to FREQUENCY_COUNT sorts the list by the accesses
+        counted so far, keeping the order of stations with equal counts.
+        */
+        void setAccessPolicy(AccessPolicy policy);
+
+        /**
+        * Retrieves how the list reorganizes itself on lookups.
+        * @return: The current policy; STATIC_ORDER by default.
+        */
+        AccessPolicy accessPolicy() const;
+
+        /**
+        * Retrieves how often a station was looked up while an adaptive
+        policy was on.
+        * @param station_name A string representing the station's name.
+        * @return: The access count; 0 if the station does not exist.
+        */
+        long getAccessCount(const std::string& station_name) const;
+
+        /**
+        * Finds how deep a station sits in the list.
+        * @param station_name A string representing the station's name.
+        * @return: The station's position, 0 for the front, i.e. the number
+        of stations a walk from the front passes before reaching it; -1 if
+        the station does not exist.
+        */
+        int getStationPosition(const std::string& station_name) const;
+
         /**
         * Merges the dishes and ingredients of two specified stations.
         * @param station_name1 The name of the first station.
         * @param station_name2 The name of the second station.
         * @post: The second station is removed from the list, and its
-        contents are added to the first station.
+        contents are added to the first station. The second station is then
+        deallocated; its reservations are released into the first station.
         * @return: True if both stations were found and merged; false
         otherwise.
         */
@@ -100,10 +211,90 @@ class StationManager : public LinkedList<KitchenStation*> {
         order for a specific dish.
         * @param dish_name A string representing the name of the dish.
         * @return: True if any station can complete the order; false
-        otherwise.
+        otherwise. Answered from the routing cache when possible; otherwise,
+        with parallel checks on, the stations are asked in parallel and the
+        check stops at the first station that can. A dish missed before is
+        answered through capableStations instead, so its answer is cached.
         */
         bool canCompleteOrder(const std::string& dish_name);
 
+        /**
+        * Checks if any station in the station manager can complete an
+        order for a specific dish.
+        * @param dish_id The dish's id, from findDishId.
+        * @return: As canCompleteOrder by name, without comparing strings.
+        */
+        bool canCompleteOrder(RecipeCatalog::DishId dish_id);
+
+        /**
+        * Checks a whole list of dishes at once, e.g. to refresh a menu.
+        * @param dish_names The names of the dishes.
+        * @return: For each dish, in the same sequence, whether any station
+        can complete an order for it. Dishes not in the routing cache are
+        answered in one pass over the stations (in parallel with parallel
+        checks on) that stops once every dish is known to be available.
+        */
+        std::vector<bool> canCompleteOrders(const std::vector<std::string>& dish_names);
+
+        /**
+        * Checks a whole list of dishes at once.
+        * @param dish_ids The dishes' ids, from findDishId.
+        * @return: As canCompleteOrders by name.
+        */
+        std::vector<bool> canCompleteOrders(const std::vector<RecipeCatalog::DishId>& dish_ids);
+
+        /**
+        * Looks up the id the id-based operations take for a dish name. Ids
+        are dense, shared by every station and stable for the life of the
+        process, so callers can resolve once and keep the id. Only
+        assigning a dish to a station registers a new id.
+        * @param dish_name A string representing the name of the dish.
+        * @return: The dish's id; -1 if no station has ever been assigned
+        the dish.
+        */
+        RecipeCatalog::DishId findDishId(const std::string& dish_name) const;
+
+        /**
+        * Resolves a dish id back to its name.
+        * @param dish_id The dish's id, from findDishId.
+        * @return: The name; an empty string if dish_id is not registered.
+        */
+        std::string dishName(RecipeCatalog::DishId dish_id) const;
+
+        /**
+        * Sets how many pool threads check stations in parallel on a routing
+        cache miss. The calling thread checks stations too.
+        * @param thread_count The number of pool threads; 0 to check the
+        stations one by one on the calling thread.
+        * @post: Checks spanning fewer than PARALLEL_CHECK_CHUNK stations
+        still run on the calling thread only. Checks already running finish
+        on the pool they started with.
+        */
+        void setParallelChecks(int thread_count);
+
+        /**
+        * Retrieves how many pool threads check stations in parallel.
+        * @return: The number of pool threads; 0 if parallel checks are off.
+        */
+        int parallelChecks() const;
+
+        /**
+        * Retrieves every station that can currently complete an order for
+        a specific dish.
+        * @param dish_name A string representing the name of the dish.
+        * @return: The capable stations, in no particular order. Answered from
+        the routing cache when possible.
+        */
+        std::vector<KitchenStation*> capableStations(const std::string& dish_name);
+
+        /**
+        * Retrieves every station that can currently complete an order for
+        a specific dish.
+        * @param dish_id The dish's id, from findDishId.
+        * @return: As capableStations by name.
+        */
+        std::vector<KitchenStation*> capableStations(RecipeCatalog::DishId dish_id);
+
         /**
         * Prepares a dish at a specific station if possible.
         * @param station_name A string representing the station's name.
@@ -114,6 +305,457 @@ class StationManager : public LinkedList<KitchenStation*> {
         otherwise.
         */
         bool prepareDishAtStation(const std::string& station_name, const std::string& dish_name_);
+
+        /**
+        * Prepares a dish at a specific station if possible.
+        * @param station_name A string representing the station's name.
+        * @param dish_id The dish's id, from findDishId.
+        * @return: As prepareDishAtStation by name.
+        */
+        bool prepareDishAtStation(const std::string& station_name, RecipeCatalog::DishId dish_id);
+
+        /**
+        * Prepares a dish at a station already looked up, skipping the search
+        by name.
+        * @param station A station of this manager, from findStation or
+        capableStations, that has not been removed or merged away since; or
+        nullptr.
+        * @param dish_id The dish's id, from findDishId.
+        * @return: True if the dish was prepared successfully; false
+        otherwise (including when station is nullptr).
+        */
+        bool prepareDishAtStation(KitchenStation* station, RecipeCatalog::DishId dish_id);
+
+        /**
+        * Prepares a burst of orders at a specific station with one
+        feasibility check and one deduction per ingredient.
+        * @param station_name A string representing the station's name.
+        * @param orders (dish name, servings) pairs.
+        * @return: The number of servings prepared for each order, in the
+        same sequence as orders; all 0 if the station does not exist.
+        */
+        std::vector<int> prepareBatch(const std::string& station_name, const std::vector<std::pair<std::string, int>>& orders);
+
+        /**
+        * Plans the cheapest restocking that covers a forecast of orders. The
+        plan is greedy: a dish's whole forecast is planned at the first
+        station in the list that has the dish, even when another station
+        with the dish has the stock on hand, and demand is never split
+        between stations. Every station's shortfall is then worked out over
+        its stock arrays. A shortfall is first covered by what other stations
+        have left over after their own forecast, if transfers are allowed,
+        and the rest is bought at the lowest price any station records for
+        the ingredient.
+        * @param forecast (dish name, servings) pairs; unknown dishes are
+        ignored.
+        * @param allow_transfers Whether leftover stock may be moved between
+        stations instead of buying more.
+        * @return: The purchases and transfers, and what the purchases cost.
+        Nothing is deducted, bought or moved.
+        */
+        ReplenishmentPlan planReplenishment(const std::vector<std::pair<std::string, int>>& forecast, bool allow_transfers = true) const;
+
+        /**
+        * Switches to concurrent execution: every station gets its own
+        worker thread with an inbound order queue.
+        * @post: Stations added later also get a worker, until stopWorkers.
+        */
+        void startWorkers();
+
+        /**
+        * Switches back to synchronous execution.
+        * @post: Every queued order is finished and all workers are joined.
+        */
+        void stopWorkers();
+
+        /**
+        * Checks whether stations are running on worker threads.
+        * @return: True between startWorkers and stopWorkers; false otherwise.
+        */
+        bool workersRunning() const;
+
+        /**
+        * Routes an order to a specific station without waiting for it.
+        * @param station_name A string representing the station's name.
+        * @param dish_name A string representing the name of the dish.
+        * @post: With workers running, the order is queued on the station's
+        worker; otherwise it is prepared immediately.
+        * @return: A future that becomes true if the dish was prepared and
+        false otherwise (including when the station does not exist).
+        */
+        std::future<bool> prepareDishAtStationAsync(const std::string& station_name, const std::string& dish_name);
+
+        /**
+        * Routes an order to a specific station without waiting for it.
+        * @param station_name A string representing the station's name.
+        * @param dish_id The dish's id, from findDishId.
+        * @return: As prepareDishAtStationAsync by name.
+        */
+        std::future<bool> prepareDishAtStationAsync(const std::string& station_name, RecipeCatalog::DishId dish_id);
+
+        /**
+        * Routes an order to a station already looked up, skipping the search
+        by name.
+        * @param station A station of this manager, from findStation or
+        capableStations, that has not been removed or merged away since; or
+        nullptr.
+        * @param dish_id The dish's id, from findDishId.
+        * @return: As prepareDishAtStationAsync by name; false if station is
+        nullptr.
+        */
+        std::future<bool> prepareDishAtStationAsync(KitchenStation* station, RecipeCatalog::DishId dish_id);
+
+        /**
+        * Sends an order to the least-loaded station that can complete it.
+        * @param dish_name A string representing the name of the dish.
+        * @post: With workers running, the order is queued on the capable
+        station whose worker has the shortest backlog; idle workers may
+        later steal it if their station can make it too. Otherwise the
+        first capable station prepares it immediately.
+        * @return: A future that becomes true if the dish was prepared and
+        false otherwise (including when no station can complete it).
+        */
+        std::future<bool> dispatchOrder(const std::string& dish_name);
+
+        /**
+        * Sends an order to the least-loaded station that can complete it.
+        * @param dish_id The dish's id, from findDishId.
+        * @return: As dispatchOrder by name.
+        */
+        std::future<bool> dispatchOrder(RecipeCatalog::DishId dish_id);
+
+        /**
+        * Summarizes the latency of every order finished by the workers.
+        * @return: Latency percentiles and how many orders were stolen.
+        */
+        OrderDispatcher::LatencyReport orderLatencyReport() const;
+
+        /**
+        * Starts recording every change to the stations in a binary event
+        log: stations added, removed and merged, dishes assigned, ingredients
+        replenished and dishes prepared (by any thread, including workers).
+        Events are buffered and written in groups by a background thread.
+        * @param log_path The log file; events are appended to it.
+        * @param snapshot_path Where snapshots of the stations are written.
+        * @param snapshot_interval Take a snapshot after this many events, at
+        the end of the next operation made while workers are stopped; 0 to
+        only take them through writeSnapshot.
+        * @post: A first snapshot is written, so the snapshot plus the log
+        describe the stations from now on.
+        * @return: True if logging started; false if it is already running,
+        workers are running, or a file could not be written.
+        */
+        bool startEventLog(const std::string& log_path, const std::string& snapshot_path, long snapshot_interval = 0);
+
+        /**
+        * Stops recording events.
+        * @post: Every event recorded so far is written to the log file.
+        */
+        void stopEventLog();
+
+        /**
+        * Writes a snapshot of every station, with the log offset it covers.
+        Must be called while no other thread uses the stations.
+        * @return: True if the snapshot was written; false if no event log is
+        running, workers are running, or the file could not be written.
+        */
+        bool writeSnapshot();
+
+        /**
+        * Rebuilds the stations from a snapshot and the tail of the log that
+        follows it.
+        * @param snapshot_path A snapshot written by startEventLog or
+        writeSnapshot.
+        * @param log_path The log the snapshot belongs to.
+        * @post: The stations are those of the snapshot with every later event
+        applied. A record cut short by a crash ends the replay.
+        * @return: True if the stations were rebuilt; false if the manager is
+        not empty, an event log is running, or the snapshot is unreadable.
+        */
+        bool recover(const std::string& snapshot_path, const std::string& log_path);
+
+        /**
+        * Loads a kitchen from a stations file and a stock file, reading
+        both a line at a time. Fields are separated by commas; empty lines
+        and lines starting with '#' are skipped.
+        * @param stations_path Lines of "station" (a station with no dishes)
+        or "station,dish,prep time,price,cuisine" followed by four fields per
+        ingredient: "name,quantity,required quantity,price". Stations are
+        added in the order they first appear.
+        * @param stock_path Lines of "station,ingredient,quantity,required
+        quantity,price", replenished into stations of the stations file.
+        * @post: Every station of the files is added with its dishes and stock.
+        A dish a station already has is skipped.
+        * @return: True if the kitchen was loaded; false if the manager is not
+        empty, a file is unreadable or a line is malformed, in which case
+        nothing is added.
+        */
+        bool loadFromFile(const std::string& stations_path, const std::string& stock_path);
+
+        /**
+        * Saves every station in the format of loadFromFile.
+        * @param stations_path Where the stations and their dishes are written.
+        * @param stock_path Where the in-stock ingredients are written.
+        * @return: True if both files were written; false if a name cannot be
+        written as a field (see LayoutFile::isWritable) or a file could not
+        be written.
+        */
+        bool saveToFile(const std::string& stations_path, const std::string& stock_path) const;
+
+        /**
+        * Loads a kitchen saved by saveToBinaryFile, decoding each station
+        without parsing text.
+        * @param path The binary layout file.
+        * @post: Every station of the file is added with its dishes and stock.
+        * @return: True if the kitchen was loaded; false if the manager is not
+        empty or the file is unreadable, in which case nothing is added.
+        */
+        bool loadFromBinaryFile(const std::string& path);
+
+        /**
+        * Saves every station, its dishes and its stock in one binary file,
+        encoded as in the event log's snapshots.
+        * @param path The file to write.
+        * @return: True if the file was written; false otherwise.
+        */
+        bool saveToBinaryFile(const std::string& path) const;
+
+        /**
+        * Starts writing the metrics of the manager and every station to a
+        Prometheus textfile-collector file.
+        * @param path The file to write, e.g. a *.prom file in node_exporter's
+        textfile directory.
+        * @param interval How often the file is rewritten.
+        * @post: A background thread writes metricsText to path right away
+        and then once per interval, replacing the file atomically.
+        * @return: True if exporting started; false if it is already running.
+        */
+        bool startMetricsExport(const std::string& path, std::chrono::milliseconds interval = std::chrono::milliseconds(15000));
+
+        /**
+        * Stops exporting metrics.
+        * @post: The file is written one last time.
+        */
+        void stopMetricsExport();
+
+        /**
+        * Renders the metrics of the manager and every station in the
+        Prometheus text format: order, stock-out and replenishment counters,
+        failed order checks by missing ingredient, servings and stock gauges,
+        and latency histograms of every operation.
+        * @return: The exposition text.
+        */
+        std::string metricsText() const;
+
+        /**
+        * Retrieves the latency histograms of the manager's own operations.
+        * @return: The manager's metrics.
+        */
+        const Metrics& metrics() const;
+
+    private:
+        //Maps each station name to the node preceding that station in the
+        //list (nullptr for the head), so by-name operations can find, unlink
+        //and relink a station in O(1). Stations tell the manager before they
+        //are renamed, so the index follows their names.
+        std::unordered_map<std::string, Node<KitchenStation*>*> station_index_;
+
+        //Adaptive lookups: with a policy other than STATIC_ORDER, findStation
+        //counts an access and moves the station forward according to the
+        //policy. Only the routing thread looks stations up by name.
+        AccessPolicy access_policy_;
+        std::unordered_map<KitchenStation*, long> access_counts_; //accesses of each station counted under an adaptive policy
+
+        //Under FREQUENCY_COUNT the list is sorted by access count, so the
+        //stations with one count form a run. A lookup moves its station from
+        //the front of its run to the back of the next run up, which is just
+        //before the front of its old run, so it never walks the list.
+        std::unordered_map<long, KitchenStation*> count_leaders_; //frontmost station of each count's run, while counts_sorted_
+        bool counts_sorted_; //true while the policy is FREQUENCY_COUNT and the list is sorted by access count
+
+        //One worker per station while workers are running. Orders are routed
+        //from a single thread; a worker only cooks at its own station, and
+        //idle workers steal through the dispatcher.
+        OrderDispatcher dispatcher_;
+        std::unordered_map<KitchenStation*, std::unique_ptr<StationWorker>> workers_;
+        bool workers_running_;
+
+        //Routing cache: dish id -> stations that can complete it right now.
+        //Stations report every flip of a dish's availability through their
+        //listener (possibly from worker threads), and the matching entry is
+        //patched in place. Dishes not yet asked about have no entry.
+        std::unordered_map<RecipeCatalog::DishId, std::vector<KitchenStation*>> route_cache_;
+        unsigned long route_generation_; //bumped by every change, so a rebuild racing one is discarded
+        std::unordered_set<RecipeCatalog::DishId> route_misses_; //dishes canCompleteOrder already answered with an early-exit scan
+        mutable std::mutex route_mutex_; //guards route_cache_, route_generation_ and route_misses_; never held while calling a station
+
+        //Event log: every change is appended while the change is applied (under
+        //the station's lock for station events), so replaying the log in order
+        //reproduces the stations. Snapshots are only written while workers are
+        //stopped so that no event can land on both sides of one.
+        std::unique_ptr<InventoryLog> event_log_;
+        std::string snapshot_path_;
+        long snapshot_interval_;
+        std::atomic<long> events_since_snapshot_;
+
+        //Metrics: the manager times its own operations; each station counts its
+        //own. The exporter copies the list from its own thread, so every change
+        //to the list's links is made under list_mutex_, and renders from the
+        //copy under render_mutex_, which unlinkStation waits on.
+        Metrics metrics_;
+        std::unique_ptr<MetricsExporter> metrics_exporter_;
+        mutable std::mutex list_mutex_; //guards the list's links against the exporter
+        mutable std::shared_mutex render_mutex_; //held shared while metricsText reads stations it copied; unlinked stations are freed only once it is free
+
+        //Parallel checks: on a routing cache miss the stations are split into
+        //chunks of at least PARALLEL_CHECK_CHUNK, one per thread, since a single
+        //station answers in well under a microsecond.
+        static const int PARALLEL_CHECK_CHUNK = 64;
+        std::shared_ptr<ThreadPool> check_pool_; //read and replaced with std::atomic_load/store, so a check keeps the pool it started with
+
+        //First integer of a binary layout file
+        static const int LAYOUT_MAGIC = 0x4c545342;
+
+        /**
+        * Applies an availability flip reported by a station to the routing
+        cache.
+        * @param station The station whose answer changed.
+        * @param dish_id The dish's id.
+        * @param available Whether the station can complete the dish now.
+        */
+        void onAvailabilityChange(KitchenStation* station, RecipeCatalog::DishId dish_id, bool available);
+
+        /**
+        * Moves a station's entry in station_index_ to its new name.
+        * @param station A station in the list that is being renamed.
+        * @param new_name The name it is about to take.
+        * @return: True if the rename may go ahead; false if another station
+        has new_name.
+        */
+        bool onRename(KitchenStation* station, const std::string& new_name);
+
+        /**
+        * Detaches a station from the routing cache.
+        * @param station A station that is leaving the list.
+        * @post: The station no longer reports to the cache and appears in no
+        entry.
+        */
+        void forgetRoutes(KitchenStation* station);
+
+        /**
+        * Drops the cached entries of a station's dishes.
+        * @param station A station joining the list.
+        * @post: The entries are rebuilt on their next query, so they include
+        the station if it can complete them.
+        */
+        void invalidateRoutes(KitchenStation* station);
+
+        /**
+        * Stops the worker of a station, if any, after its queue drains.
+        * @param station A pointer to the KitchenStation.
+        */
+        void stopWorker(KitchenStation* station);
+
+        /**
+        * Runs a check over every station, split into chunks run in parallel
+        when parallel checks are on.
+        * @param stations The stations to check.
+        * @param check Called with each chunk's [begin, end) range of
+        stations; called concurrently for different chunks.
+        */
+        void forEachStationChunk(const std::vector<KitchenStation*>& stations, const std::function<void(int, int)>& check);
+
+        /**
+        * Returns the node holding the station that follows prev_ptr.
+        * @param prev_ptr A node of the list, or nullptr for the head.
+        * @return: The node after prev_ptr, or the head node if prev_ptr is
+        nullptr.
+        */
+        Node<KitchenStation*>* nodeAfter(Node<KitchenStation*>* prev_ptr) const;
+
+        /**
+        * Unlinks a station from the list and from the name index without
+        deallocating the station.
+        * @param station_name A string representing the station's name.
+        * @post: No metricsText render still reads the station, so the caller
+        may free it.
+        * @return: The unlinked station if found; nullptr otherwise.
+        */
+        KitchenStation* unlinkStation(const std::string& station_name);
+
+        /**
+        * Moves a station forward in the list without allocating.
+        * @param prev The node preceding the station, or nullptr for the head.
+        * @param new_prev The node the station should follow, or nullptr for
+        the front; must come before the station in the list.
+        * @post: The station follows new_prev and station_index_ is current.
+        */
+        void relinkStation(Node<KitchenStation*>* prev, Node<KitchenStation*>* new_prev);
+
+        /**
+        * Counts a lookup of a station and reorders the list according to the
+        access policy.
+        * @param prev The node preceding the station, or nullptr for the head.
+        */
+        void recordAccess(Node<KitchenStation*>* prev);
+
+        /**
+        * Sorts the list by access count, most accessed first, keeping the
+        order of stations with equal counts.
+        * @post: count_leaders_ holds the front of every count's run and
+        counts_sorted_ is set.
+        */
+        void sortByAccessCount();
+
+        /**
+        * Appends an event to the log, if one is running.
+        * @param type The kind of event.
+        * @param body The encoded event.
+        */
+        void logEvent(InventoryLog::EventType type, const InventoryLog::Writer& body);
+
+        /**
+        * Makes a station record its own changes in the event log.
+        * @param station A station in the list.
+        */
+        void watchStock(KitchenStation* station);
+
+        /**
+        * Writes a snapshot if snapshot_interval_ events were logged since the
+        last one and workers are stopped.
+        */
+        void snapshotIfDue();
+
+        /**
+        * Applies one logged event to the stations.
+        * @param type The kind of event.
+        * @param body The encoded event.
+        */
+        void replayEvent(InventoryLog::EventType type, InventoryLog::Reader& body);
+
+        /**
+        * Builds a station from the encoding of Writer::putStation.
+        * @param body The encoded station.
+        * @return: A new station owned by the caller, or nullptr if the
+        encoding is cut short.
+        */
+        static KitchenStation* readStation(InventoryLog::Reader& body);
+
+        /**
+        * Builds stations from consecutive encodings of Writer::putStation.
+        * @param body The encoded stations.
+        * @param count The number of stations to read.
+        * @param stations Receives the new stations, owned by the caller.
+        * @return: True if every station was read; false if the encoding is
+        cut short, in which case stations is left empty.
+        */
+        static bool readStations(InventoryLog::Reader& body, int count, std::vector<KitchenStation*>& stations);
+
+        /**
+        * Adds stations built for this manager.
+        * @param stations New stations; any whose name is taken is deleted.
+        */
+        void addStations(const std::vector<KitchenStation*>& stations);
 };
 
 #endif // STATIONMANAGER_HPP
\ No newline at end of file
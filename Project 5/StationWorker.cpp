@@ -0,0 +1,206 @@
+/**
+ * @brief This file contains the implementation of the StationWorker class, which runs the orders of one kitchen station on its own thread in a virtual bistro simulation.
+*/
+
+#include "StationWorker.hpp"
+
+/**
+* Parameterized Constructor
+* @param station A pointer to the KitchenStation this worker cooks for.
+* @param dispatcher The dispatcher to register with for work stealing,
+or nullptr to only ever cook the worker's own orders.
+* @post: Starts the worker thread with an empty order queue.
+*/
+StationWorker::StationWorker(KitchenStation* station, OrderDispatcher* dispatcher)
+    : station_(station), dispatcher_(dispatcher), stopping_(false), steal_requested_(false), busy_(false), thread_(&StationWorker::run, this) {
+    if (dispatcher_ != nullptr)
+        dispatcher_->addWorker(this);
+}
+
+/**
+* Destructor
+* @post: Unregisters from the dispatcher, finishes every queued
+order, then joins the worker thread.
+*/
+StationWorker::~StationWorker() {
+    //No peer can steal from this worker once it is unregistered
+    if (dispatcher_ != nullptr)
+        dispatcher_->removeWorker(this);
+
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        stopping_ = true;
+    }
+    queue_ready_.notify_one();
+    thread_.join();
+}
+
+/**
+* Queues an order for the station.
+* @param dish_name A string representing the name of the dish.
+* @return: A future that becomes true if the station prepared the
+dish and false otherwise.
+*/
+std::future<bool> StationWorker::submit(const std::string& dish_name) {
+    return submit(RecipeCatalog::instance().findDishId(dish_name));
+}
+
+/**
+* Queues an order for the station.
+* @param dish_id The dish's id in the recipe catalog.
+* @return: As submit by name.
+*/
+std::future<bool> StationWorker::submit(RecipeCatalog::DishId dish_id) {
+    static std::atomic<unsigned long> next_ticket{0};
+    std::future<bool> result;
+    int queued;
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        queue_.push_back(Order{next_ticket.fetch_add(1, std::memory_order_relaxed), dish_id, std::promise<bool>(), std::chrono::steady_clock::now()});
+        result = queue_.back().result.get_future();
+        queued = queue_.size();
+    }
+    queue_ready_.notify_one();
+
+    //A backlog is what idle peers are waiting for
+    if (dispatcher_ != nullptr)
+        dispatcher_->orderQueued(this, queued);
+
+    return result;
+}
+
+/**
+* Retrieves the number of orders waiting in the queue.
+* @return: The queue length.
+*/
+int StationWorker::queuedOrders() const {
+    std::lock_guard<std::mutex> lock(queue_mutex_);
+    return queue_.size();
+}
+
+/**
+* Retrieves the worker's load.
+* @return: The queue length plus one if an order is being cooked.
+*/
+int StationWorker::load() const {
+    std::lock_guard<std::mutex> lock(queue_mutex_);
+    return queue_.size() + (busy_ ? 1 : 0);
+}
+
+/**
+* Gives the newest queued order that thief's station can complete
+to thief.
+* @param thief An idle worker.
+* @post: The order, if any, is moved to the front of thief's queue.
+* @return: True if an order was handed over; false otherwise.
+*/
+bool StationWorker::handOver(StationWorker& thief) {
+    std::vector<std::pair<unsigned long, RecipeCatalog::DishId>> candidates;
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+
+        //Newest first: the oldest orders are next in line here anyway
+        for (int i = queue_.size() - 1; i >= 0 && candidates.size() < STEAL_SCAN; i--)
+            candidates.push_back(std::make_pair(queue_[i].ticket, queue_[i].dish_id));
+    }
+
+    //Asking thief's station without the queue lock, so submit and this worker never wait on it
+    size_t pick = 0;
+    while (pick < candidates.size() && !thief.station_->isAvailable(candidates[pick].second))
+        pick++;
+
+    if (pick == candidates.size())
+        return false;
+
+    Order order;
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        int i = queue_.size() - 1;
+
+        //The order may have been cooked or stolen meanwhile
+        while (i >= 0 && queue_[i].ticket != candidates[pick].first)
+            i--;
+
+        if (i < 0)
+            return false;
+
+        order = std::move(queue_[i]);
+        queue_.erase(queue_.begin() + i);
+    }
+
+    //The victim's lock is released first so two workers never hold both queues
+    order.stolen = true;
+    {
+        std::lock_guard<std::mutex> lock(thief.queue_mutex_);
+        thief.queue_.push_front(std::move(order));
+    }
+    thief.queue_ready_.notify_one();
+    return true;
+}
+
+/**
+* Wakes the worker, if idle, to try to steal from its peers.
+*/
+void StationWorker::wakeToSteal() {
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        steal_requested_ = true;
+    }
+    queue_ready_.notify_one();
+}
+
+/**
+* Retrieves the station this worker cooks for.
+* @return: A pointer to the KitchenStation.
+*/
+KitchenStation* StationWorker::getStation() const {
+    return station_;
+}
+
+/**
+* The worker thread's loop.
+* @post: Prepares queued orders one at a time until stopping_ is set
+and the queue is empty. When idle, tries once to steal from its peers,
+then sleeps until an order arrives or a peer's backlog wakes it.
+*/
+void StationWorker::run() {
+    while (true) {
+        Order order;
+        {
+            std::unique_lock<std::mutex> lock(queue_mutex_);
+            busy_ = false;
+
+            while (queue_.empty() && !stopping_) {
+                if (dispatcher_ == nullptr) {
+                    queue_ready_.wait(lock);
+                    continue;
+                }
+
+                //Idle: registered first, so a backlog appearing during the steal still wakes this worker
+                steal_requested_ = false;
+                lock.unlock();
+                dispatcher_->markIdle(this);
+                bool stole = dispatcher_->stealFor(*this);
+                lock.lock();
+
+                if (!stole)
+                    queue_ready_.wait(lock, [this] { return !queue_.empty() || stopping_ || steal_requested_; });
+            }
+
+            if (queue_.empty())
+                return; //stopping and nothing left to prepare
+
+            order = std::move(queue_.front());
+            queue_.pop_front();
+            busy_ = true;
+        }
+
+        //Cooking happens outside the queue lock so new orders can keep arriving
+        order.result.set_value(station_->prepareDish(order.dish_id));
+
+        if (dispatcher_ != nullptr) {
+            std::chrono::duration<double, std::micro> latency = std::chrono::steady_clock::now() - order.queued_at;
+            dispatcher_->recordOrder(latency.count(), order.stolen);
+        }
+    }
+}
@@ -0,0 +1,124 @@
+/**
+ * @brief This file contains the declaration of the StationWorker class, which runs the orders of one kitchen station on its own thread in a virtual bistro simulation.
+*/
+
+#ifndef STATIONWORKER_HPP
+#define STATIONWORKER_HPP
+
+#include "KitchenStation.hpp"
+#include "OrderDispatcher.hpp"
+#include <string>
+#include <chrono>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <future>
+#include <thread>
+#include <atomic>
+
+class StationWorker {
+    public:
+        /**
+        * Parameterized Constructor
+        * @param station A pointer to the KitchenStation this worker cooks for.
+        * @param dispatcher The dispatcher to register with for work stealing,
+        or nullptr to only ever cook the worker's own orders.
+        * @post: Starts the worker thread with an empty order queue.
+        */
+        StationWorker(KitchenStation* station, OrderDispatcher* dispatcher = nullptr);
+
+        /**
+        * Destructor
+        * @post: Unregisters from the dispatcher, finishes every queued
+        order, then joins the worker thread.
+        */
+        ~StationWorker();
+
+        StationWorker(const StationWorker&) = delete;
+        StationWorker& operator=(const StationWorker&) = delete;
+
+        /**
+        * Queues an order for the station.
+        * @param dish_name A string representing the name of the dish.
+        * @return: A future that becomes true if the station prepared the
+        dish and false otherwise.
+        */
+        std::future<bool> submit(const std::string& dish_name);
+
+        /**
+        * Queues an order for the station.
+        * @param dish_id The dish's id in the recipe catalog.
+        * @return: As submit by name.
+        */
+        std::future<bool> submit(RecipeCatalog::DishId dish_id);
+
+        /**
+        * Retrieves the number of orders waiting in the queue.
+        * @return: The queue length.
+        */
+        int queuedOrders() const;
+
+        /**
+        * Retrieves the worker's load.
+        * @return: The queue length plus one if an order is being cooked.
+        */
+        int load() const;
+
+        /**
+        * Gives the newest queued order that thief's station can complete
+        to thief. Only the newest STEAL_SCAN orders are considered, and
+        thief's station is asked about them without holding this worker's
+        queue lock.
+        * @param thief An idle worker.
+        * @post: The order, if any, is moved to the front of thief's queue.
+        * @return: True if an order was handed over; false otherwise.
+        */
+        bool handOver(StationWorker& thief);
+
+        /**
+        * Wakes the worker, if idle, to try to steal from its peers.
+        */
+        void wakeToSteal();
+
+        /**
+        * Retrieves the station this worker cooks for.
+        * @return: A pointer to the KitchenStation.
+        */
+        KitchenStation* getStation() const;
+
+    private:
+        /**
+        * An order waiting for the station.
+        */
+        struct Order {
+            unsigned long ticket; //identifies the order across every worker, since stolen orders keep theirs
+            RecipeCatalog::DishId dish_id; //-1 if the dish was never registered, which no station can make
+            std::promise<bool> result;
+            std::chrono::steady_clock::time_point queued_at;
+            bool stolen = false;
+        };
+
+        //How many of a victim's newest orders a thief looks at per steal
+        static const int STEAL_SCAN = 16;
+
+        KitchenStation* station_; //the station whose orders this worker prepares
+        OrderDispatcher* dispatcher_; //peers to steal from, or nullptr
+        std::deque<Order> queue_; //orders in arrival order
+        mutable std::mutex queue_mutex_; //guards queue_ and stopping_
+        std::condition_variable queue_ready_; //signalled when an order arrives, a steal is requested or the worker stops
+        bool stopping_; //set by the destructor; the queue is drained before the thread exits
+        bool steal_requested_; //set by wakeToSteal, cleared when the worker tries
+        bool busy_; //true while an order is being cooked
+        std::thread thread_; //started last, after every other member is ready
+
+        /**
+        * The worker thread's loop.
+        * @post: Prepares queued orders one at a time until stopping_ is set
+        and the queue is empty. When idle, tries once to steal from its
+        peers, then sleeps until an order arrives or a peer's backlog wakes
+        it.
+        */
+        void run();
+};
+
+#endif // STATIONWORKER_HPP
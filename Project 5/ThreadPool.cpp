@@ -0,0 +1,120 @@
+/**
+ * @brief This file contains the implementation of the ThreadPool class, which splits a loop across a fixed set of threads in a virtual bistro simulation.
+*/
+
+#include "ThreadPool.hpp"
+#include <algorithm>
+
+/**
+* Parameterized Constructor
+* @param thread_count The number of threads to start (at least 1).
+* @post: Starts the threads, idle until parallelFor is called.
+*/
+ThreadPool::ThreadPool(int thread_count) : stopping_(false) {
+    for (int i = 0; i < std::max(thread_count, 1); i++)
+        threads_.emplace_back(&ThreadPool::run, this);
+}
+
+/**
+* Destructor
+* @post: Joins every thread.
+*/
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(jobs_mutex_);
+        stopping_ = true;
+    }
+    job_ready_.notify_all();
+
+    for (size_t i = 0; i < threads_.size(); i++)
+        threads_[i].join();
+}
+
+/**
+* Retrieves the number of threads in the pool.
+* @return: The thread count.
+*/
+int ThreadPool::size() const {
+    return threads_.size();
+}
+
+/**
+* Runs body(0) ... body(count - 1) on the pool's threads and the calling
+thread, and waits for all of them.
+* @param count The number of iterations.
+* @param body The iteration; called concurrently, once per index.
+* @post: Every iteration has finished.
+*/
+void ThreadPool::parallelFor(int count, const std::function<void(int)>& body) {
+    if (count <= 0)
+        return;
+
+    std::shared_ptr<Job> job(new Job());
+    job->body = &body;
+    job->count = count;
+
+    {
+        std::lock_guard<std::mutex> lock(jobs_mutex_);
+        jobs_.push_back(job);
+    }
+    job_ready_.notify_all();
+
+    //The caller works too instead of only waiting
+    work(*job);
+
+    {
+        std::unique_lock<std::mutex> lock(job->done_mutex);
+        job->finished.wait(lock, [&job] { return job->done.load() == job->count; });
+    }
+
+    //Every index is claimed, so no thread needs the job any more
+    std::lock_guard<std::mutex> lock(jobs_mutex_);
+    auto found = std::find(jobs_.begin(), jobs_.end(), job);
+    if (found != jobs_.end())
+        jobs_.erase(found);
+}
+
+/**
+* A pool thread's loop.
+* @post: Helps with the oldest job until stopping_ is set.
+*/
+void ThreadPool::run() {
+    std::unique_lock<std::mutex> lock(jobs_mutex_);
+
+    while (true) {
+        job_ready_.wait(lock, [this] { return stopping_ || !jobs_.empty(); });
+
+        if (stopping_)
+            return;
+
+        std::shared_ptr<Job> job = jobs_.front();
+
+        //A job with every index claimed only waits for its last iterations
+        if (job->next.load() >= job->count) {
+            jobs_.pop_front();
+            continue;
+        }
+
+        lock.unlock();
+        work(*job);
+        lock.lock();
+    }
+}
+
+/**
+* Claims and runs iterations of a job until none are left.
+* @param job The job.
+*/
+void ThreadPool::work(Job& job) {
+    int i;
+
+    while ((i = job.next.fetch_add(1)) < job.count) {
+        (*job.body)(i);
+
+        //The last iteration to finish wakes the caller
+        if (job.done.fetch_add(1) + 1 == job.count) {
+            std::lock_guard<std::mutex> lock(job.done_mutex);
+            job.finished.notify_all();
+        }
+    }
+}
@@ -0,0 +1,82 @@
+/**
+ * @brief This file contains the declaration of the ThreadPool class, which splits a loop across a fixed set of threads in a virtual bistro simulation.
+*/
+
+#ifndef THREADPOOL_HPP
+#define THREADPOOL_HPP
+
+#include <vector>
+#include <deque>
+#include <memory>
+#include <functional>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <thread>
+
+class ThreadPool {
+    public:
+        /**
+        * Parameterized Constructor
+        * @param thread_count The number of threads to start (at least 1).
+        * @post: Starts the threads, idle until parallelFor is called.
+        */
+        ThreadPool(int thread_count);
+
+        /**
+        * Destructor
+        * @post: Joins every thread.
+        */
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        /**
+        * Retrieves the number of threads in the pool.
+        * @return: The thread count.
+        */
+        int size() const;
+
+        /**
+        * Runs body(0) ... body(count - 1) on the pool's threads and the
+        calling thread, and waits for all of them.
+        * @param count The number of iterations.
+        * @param body The iteration; called concurrently, once per index.
+        * @post: Every iteration has finished.
+        */
+        void parallelFor(int count, const std::function<void(int)>& body);
+
+    private:
+        /**
+        * One parallelFor call. Threads claim indices until none are left.
+        */
+        struct Job {
+            const std::function<void(int)>* body;
+            int count;
+            std::atomic<int> next{0}; //next index to claim
+            std::atomic<int> done{0}; //iterations finished
+            std::mutex done_mutex; //pairs with finished
+            std::condition_variable finished; //signalled when done reaches count
+        };
+
+        std::vector<std::thread> threads_;
+        std::deque<std::shared_ptr<Job>> jobs_; //jobs that may have indices left
+        std::mutex jobs_mutex_; //guards jobs_ and stopping_
+        std::condition_variable job_ready_; //signalled when a job is added or the pool stops
+        bool stopping_;
+
+        /**
+        * A pool thread's loop.
+        * @post: Helps with the oldest job until stopping_ is set.
+        */
+        void run();
+
+        /**
+        * Claims and runs iterations of a job until none are left.
+        * @param job The job.
+        */
+        static void work(Job& job);
+};
+
+#endif // THREADPOOL_HPP
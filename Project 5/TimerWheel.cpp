@@ -0,0 +1,86 @@
+/**
+ * @brief This file contains the implementation of the TimerWheel class, which tracks deadlines in a hashed wheel of time slots in a virtual bistro simulation.
+*/
+
+#include "TimerWheel.hpp"
+#include <cstddef>
+
+/**
+* Parameterized Constructor
+* @param slot_count The number of slots.
+* @post: Initializes an empty wheel that starts at the first tick passed
+to advance.
+*/
+TimerWheel::TimerWheel(int slot_count) : slot_count_(slot_count > 0 ? slot_count : 1), current_(0), started_(false), size_(0) {
+}
+
+/**
+* Adds a deadline.
+* @param id The caller's identifier for the timer.
+* @param deadline The tick at which the timer is due.
+* @post: The timer is reported by the first advance to reach deadline.
+*/
+void TimerWheel::schedule(unsigned long id, long long deadline) {
+    if (slots_.empty())
+        slots_.resize(slot_count_);
+
+    //A deadline already passed goes in the next slot advance visits
+    if (started_ && deadline <= current_)
+        deadline = current_ + 1;
+
+    slots_[deadline % slots_.size()].push_back(Timer{id, deadline});
+    size_++;
+}
+
+/**
+* Moves the wheel forward to now.
+* @param now The current tick; earlier ticks are ignored.
+* @param due Receives the id of every timer whose deadline is at or
+before now.
+*/
+void TimerWheel::advance(long long now, std::vector<unsigned long>& due) {
+    if (!started_) {
+        started_ = true;
+        current_ = now - 1;
+    }
+
+    if (now <= current_)
+        return;
+
+    //Nothing was ever scheduled, so there is no slot to visit
+    if (slots_.empty()) {
+        current_ = now;
+        return;
+    }
+
+    //After a full turn every slot has been seen, so longer gaps visit each slot once
+    long long ticks = now - current_;
+    if (ticks > (long long)slots_.size())
+        ticks = slots_.size();
+
+    for (long long t = 1; t <= ticks; t++) {
+        std::vector<Timer>& slot = slots_[(current_ + t) % slots_.size()];
+        int kept = 0;
+
+        //Reporting what is due and keeping timers due on a later turn
+        for (size_t i = 0; i < slot.size(); i++) {
+            if (slot[i].deadline <= now)
+                due.push_back(slot[i].id);
+            else
+                slot[kept++] = slot[i];
+        }
+
+        size_ -= slot.size() - kept;
+        slot.resize(kept);
+    }
+
+    current_ = now;
+}
+
+/**
+* Retrieves the number of timers not reported yet.
+* @return: The number of scheduled timers.
+*/
+int TimerWheel::size() const {
+    return size_;
+}
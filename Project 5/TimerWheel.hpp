@@ -0,0 +1,64 @@
+/**
+ * @brief This file contains the declaration of the TimerWheel class, which tracks deadlines in a hashed wheel of time slots in a virtual bistro simulation.
+*/
+
+#ifndef TIMERWHEEL_HPP
+#define TIMERWHEEL_HPP
+
+#include <vector>
+
+class TimerWheel {
+    public:
+        /**
+        * Parameterized Constructor
+        * @param slot_count The number of slots; deadlines within slot_count
+        ticks of now are visited exactly once.
+        * @post: Initializes an empty wheel that starts at the first tick
+        passed to advance. The slots are only allocated by the first
+        schedule, so an unused wheel costs nothing.
+        */
+        TimerWheel(int slot_count = 1024);
+
+        /**
+        * Adds a deadline. Cancelled timers are not removed; the owner ignores
+        ids it no longer knows when they come due.
+        * @param id The caller's identifier for the timer.
+        * @param deadline The tick at which the timer is due.
+        * @post: The timer is reported by the first advance to reach deadline
+        (the next one if deadline has already passed).
+        */
+        void schedule(unsigned long id, long long deadline);
+
+        /**
+        * Moves the wheel forward to now.
+        * @param now The current tick; earlier ticks are ignored.
+        * @param due Receives the id of every timer whose deadline is at or
+        before now.
+        * @post: Each slot passed over is visited once, so the cost is the
+        ticks elapsed (capped at the slot count) plus the timers looked at.
+        */
+        void advance(long long now, std::vector<unsigned long>& due);
+
+        /**
+        * Retrieves the number of timers not reported yet.
+        * @return: The number of scheduled timers.
+        */
+        int size() const;
+
+    private:
+        /**
+        * A scheduled timer.
+        */
+        struct Timer {
+            unsigned long id;
+            long long deadline;
+        };
+
+        std::vector<std::vector<Timer>> slots_; //slot (deadline % slot count) -> timers; empty until the first schedule
+        int slot_count_; //number of slots once allocated
+        long long current_; //the last tick advance reached
+        bool started_; //false until the first advance sets current_
+        int size_; //timers in all slots
+};
+
+#endif // TIMERWHEEL_HPP
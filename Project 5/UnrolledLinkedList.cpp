@@ -0,0 +1,263 @@
+/** ADT list: Unrolled singly linked list implementation.
+
+ Implementation file for the class UnrolledLinkedList.
+ @file UnrolledLinkedList.cpp */
+
+#include "UnrolledLinkedList.hpp"  // Header file
+#include <string>
+
+// constructor
+template<class T, int BLOCK_SIZE>
+UnrolledLinkedList<T, BLOCK_SIZE>::UnrolledLinkedList() : head_ptr_(nullptr), tail_ptr_(nullptr), item_count_(0)
+{
+}  // end default constructor
+
+
+// copy constructor, copies are packed into full blocks
+template<class T, int BLOCK_SIZE>
+UnrolledLinkedList<T, BLOCK_SIZE>::UnrolledLinkedList(const UnrolledLinkedList<T, BLOCK_SIZE>& a_list)
+   : head_ptr_(nullptr), tail_ptr_(nullptr), item_count_(0)
+{
+   Block* last_ptr = nullptr;
+   for (Block* orig_ptr = a_list.head_ptr_; orig_ptr != nullptr; orig_ptr = orig_ptr->next_)
+   {
+      for (int i = 0; i < orig_ptr->count_; i++)
+      {
+         // Start a new block when the last one is full
+         if (last_ptr == nullptr || last_ptr->count_ == BLOCK_SIZE)
+         {
+            Block* new_block_ptr = new Block();
+            if (last_ptr == nullptr)
+               head_ptr_ = new_block_ptr;
+            else
+               last_ptr->next_ = new_block_ptr;
+            last_ptr = new_block_ptr;
+         }  // end if
+
+         last_ptr->items_[last_ptr->count_++] = orig_ptr->items_[i];
+         item_count_++;
+      }  // end for
+   }  // end for
+
+   tail_ptr_ = last_ptr;
+}  // end copy constructor
+
+
+// destructor
+template<class T, int BLOCK_SIZE>
+UnrolledLinkedList<T, BLOCK_SIZE>::~UnrolledLinkedList()
+{
+   clear();
+}  // end destructor
+
+
+/**@return true if list is empty - item_count_ == 0 */
+template<class T, int BLOCK_SIZE>
+bool UnrolledLinkedList<T, BLOCK_SIZE>::isEmpty() const
+{
+   return item_count_ == 0;
+}  // end isEmpty
+
+
+/**@return the number of items in the list - item_count_ */
+template<class T, int BLOCK_SIZE>
+int UnrolledLinkedList<T, BLOCK_SIZE>::getLength() const
+{
+   return item_count_;
+}  // end getLength
+
+
+/**
+ @pre list positions follow traditional indexing from 0 to item_count_ -1
+ @param position indicating point of insertion
+ @param new_entry to be inserted in list
+ @post new_entry is added at position in list (the entry previously at that position is now at position+1)
+ @return true if valid position (0 <= position <= item_count_) */
+template<class T, int BLOCK_SIZE>
+bool UnrolledLinkedList<T, BLOCK_SIZE>::insert(int position, const T& new_entry)
+{
+   bool able_to_insert = (position >= 0) && (position <= item_count_);
+   if (able_to_insert)
+   {
+      Block* block_ptr = nullptr;
+      int offset = 0;
+
+      if (head_ptr_ == nullptr)
+      {
+         head_ptr_ = new Block();
+         tail_ptr_ = head_ptr_;
+         block_ptr = head_ptr_;
+      }
+      else if (position == item_count_)
+      {
+         // Appending goes to the end of the last block, or starts a new one so full blocks stay full
+         block_ptr = tail_ptr_;
+         offset = block_ptr->count_;
+         if (block_ptr->count_ == BLOCK_SIZE)
+         {
+            block_ptr = new Block();
+            tail_ptr_->next_ = block_ptr;
+            tail_ptr_ = block_ptr;
+            offset = 0;
+         }  // end if
+      }
+      else
+         block_ptr = getBlockAt(position, offset);
+
+      if (block_ptr->count_ == BLOCK_SIZE)
+      {
+         // An interior insert splits the full block, moving its upper half into a new block
+         Block* new_block_ptr = new Block();
+         int half = BLOCK_SIZE / 2;
+         for (int i = half; i < BLOCK_SIZE; i++)
+            new_block_ptr->items_[i - half] = block_ptr->items_[i];
+         new_block_ptr->count_ = BLOCK_SIZE - half;
+         block_ptr->count_ = half;
+         new_block_ptr->next_ = block_ptr->next_;
+         block_ptr->next_ = new_block_ptr;
+         if (tail_ptr_ == block_ptr)
+            tail_ptr_ = new_block_ptr;
+
+         if (offset > half)
+         {
+            block_ptr = new_block_ptr;
+            offset -= half;
+         }  // end if
+      }  // end if
+
+      // Shift the tail of the block up one slot and store the entry
+      for (int i = block_ptr->count_; i > offset; i--)
+         block_ptr->items_[i] = block_ptr->items_[i - 1];
+      block_ptr->items_[offset] = new_entry;
+      block_ptr->count_++;
+
+      item_count_++;  // Increase count of entries
+   }  // end if
+
+   return able_to_insert;
+}  // end insert
+
+
+/**
+ @pre list positions follow traditional indexing from 0 to item_count_ -1
+ @param position indicating point of deletion
+ @post entry at position is deleted, if any. List order is retained
+ @return true if there is an entry at position to be deleted, false otherwise */
+template<class T, int BLOCK_SIZE>
+bool UnrolledLinkedList<T, BLOCK_SIZE>::remove(int position)
+{
+   bool able_to_remove = (position >= 0) && (position < item_count_);
+   if (able_to_remove)
+   {
+      // Find the block holding position and the block before it
+      Block* prev_ptr = nullptr;
+      Block* block_ptr = head_ptr_;
+      int offset = position;
+      while (offset >= block_ptr->count_)
+      {
+         offset -= block_ptr->count_;
+         prev_ptr = block_ptr;
+         block_ptr = block_ptr->next_;
+      }  // end while
+
+      // Close the gap inside the block
+      for (int i = offset; i < block_ptr->count_ - 1; i++)
+         block_ptr->items_[i] = block_ptr->items_[i + 1];
+      block_ptr->count_--;
+
+      Block* next_ptr = block_ptr->next_;
+      if (block_ptr->count_ == 0)
+      {
+         // Unlink the emptied block
+         if (prev_ptr == nullptr)
+            head_ptr_ = next_ptr;
+         else
+            prev_ptr->next_ = next_ptr;
+         if (tail_ptr_ == block_ptr)
+            tail_ptr_ = prev_ptr;
+         delete block_ptr;
+      }
+      else if (next_ptr != nullptr && block_ptr->count_ + next_ptr->count_ <= BLOCK_SIZE / 2)
+      {
+         // Fold an underfull pair of blocks into one so blocks stay dense
+         for (int i = 0; i < next_ptr->count_; i++)
+            block_ptr->items_[block_ptr->count_ + i] = next_ptr->items_[i];
+         block_ptr->count_ += next_ptr->count_;
+         block_ptr->next_ = next_ptr->next_;
+         if (tail_ptr_ == next_ptr)
+            tail_ptr_ = block_ptr;
+         delete next_ptr;
+      }  // end if
+
+      item_count_--;  // Decrease count of entries
+   }  // end if
+
+   return able_to_remove;
+}  // end remove
+
+
+/**@post the list is empty and item_count_ == 0*/
+template<class T, int BLOCK_SIZE>
+void UnrolledLinkedList<T, BLOCK_SIZE>::clear()
+{
+   while (head_ptr_ != nullptr)
+   {
+      Block* next_ptr = head_ptr_->next_;
+      delete head_ptr_;
+      head_ptr_ = next_ptr;
+   }  // end while
+
+   tail_ptr_ = nullptr;
+   item_count_ = 0;
+}  // end clear
+
+
+/**
+ @pre list positions follow traditional indexing from 0 to item_count_ -1
+ @param position indicating the position of the data to be retrieved
+ @return data item found at position. If position is not a valid position < item_count_
+ throws  PrecondViolatedExcep */
+template<class T, int BLOCK_SIZE>
+T UnrolledLinkedList<T, BLOCK_SIZE>::getEntry(int position) const
+{
+    // Enforce precondition
+    bool ableToGet = (position >= 0) && (position < item_count_);
+    if (ableToGet)
+    {
+        int offset = 0;
+        Block* blockPtr = getBlockAt(position, offset);
+        return blockPtr->items_[offset];
+    }
+    else
+    {
+        std::string message = "getEntry() called with an empty list or ";
+        message  = message + "invalid position.";
+        throw(PrecondViolatedExcep(message));
+    }  // end if
+}  // end getEntry
+
+
+/************* PROTECTED METHODS ************/
+
+
+// Locates the block holding a position.
+// @param position the index of the desired entry, 0 <= position < item_count_
+// @param offset set to the index of that entry inside the returned block
+// @return  A pointer to the block holding position
+template<class T, int BLOCK_SIZE>
+typename UnrolledLinkedList<T, BLOCK_SIZE>::Block* UnrolledLinkedList<T, BLOCK_SIZE>::getBlockAt(int position, int& offset) const
+{
+    // Skip whole blocks using their counts
+    Block* cur_ptr = head_ptr_;
+    while (position >= cur_ptr->count_)
+    {
+        position -= cur_ptr->count_;
+        cur_ptr = cur_ptr->next_;
+    }  // end while
+
+    offset = position;
+    return cur_ptr;
+}  // end getBlockAt
+
+
+//  End of implementation file.
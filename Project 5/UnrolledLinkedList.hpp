@@ -0,0 +1,76 @@
+/** ADT list: Unrolled singly linked list implementation.
+    Each node holds up to BLOCK_SIZE entries in a small array, so walking
+    to a position skips whole blocks and touches about item_count_ / BLOCK_SIZE
+    nodes instead of item_count_. Same positional interface as LinkedList.
+    @file UnrolledLinkedList.hpp */
+
+#ifndef UNROLLED_LINKED_LIST_
+#define UNROLLED_LINKED_LIST_
+
+#include "PrecondViolatedExcep.hpp"
+
+// Default block size packs a node's entries into about four 64-byte cache lines
+template<class T, int BLOCK_SIZE = (256 / sizeof(T) > 4 ? 256 / sizeof(T) : 4)>
+class UnrolledLinkedList
+{
+
+public:
+   UnrolledLinkedList(); // constructor
+   UnrolledLinkedList(const UnrolledLinkedList<T, BLOCK_SIZE>& a_list); // copy constructor
+   UnrolledLinkedList<T, BLOCK_SIZE>& operator=(const UnrolledLinkedList<T, BLOCK_SIZE>& a_list) = delete;
+   virtual ~UnrolledLinkedList(); // destructor
+
+   /**@return true if list is empty - item_count_ == 0 */
+   bool isEmpty() const;
+
+    /**@return the number of items in the list - item_count_ */
+   int getLength() const;
+
+    /**
+     @pre list positions follow traditional indexing from 0 to item_count_ -1
+     @param position indicating point of insertion
+     @param new_entry to be inserted in list
+     @post new_entry is added at position in list (the entry previously at that position is now at position+1)
+     @return true if valid position (0 <= position <= item_count_) */
+   bool insert(int position, const T& new_entry);
+
+    /**
+     @pre list positions follow traditional indexing from 0 to item_count_ -1
+     @param position indicating point of deletion
+     @post entry at position is deleted, if any. List order is retained
+     @return true if there is an entry at position to be deleted, false otherwise */
+   bool remove(int position);
+
+   /**@post the list is empty and item_count_ == 0*/
+   void clear();
+
+    /**
+     @pre list positions follow traditional indexing from 0 to item_count_ -1
+     @param position indicating the position of the data to be retrieved
+     @return data item found at position. If position is not a valid position < item_count_
+            throws  PrecondViolatedExcep */
+   T getEntry(int position) const;
+
+protected:
+    // A node of the unrolled chain, holding count_ entries in items_[0..count_-1]
+    struct Block
+    {
+        T items_[BLOCK_SIZE];
+        int count_ = 0;
+        Block* next_ = nullptr;
+    };
+
+    Block* head_ptr_; // Pointer to first block in the chain
+    Block* tail_ptr_; // Pointer to last block in the chain, so appends skip the walk
+    int item_count_;  // Current count of list items
+
+    // Locates the block holding a position.
+    // @param position the index of the desired entry, 0 <= position < item_count_
+    // @param offset set to the index of that entry inside the returned block
+    // @return  A pointer to the block holding position
+    Block* getBlockAt(int position, int& offset) const;
+
+}; // end UnrolledLinkedList
+
+#include "UnrolledLinkedList.cpp"
+#endif
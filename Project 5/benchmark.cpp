@@ -0,0 +1,223 @@
+/**
+ * @brief Micro-benchmarks for the list structures behind the virtual bistro
+ * simulation. Build with `make bench` and run ./bench.
+*/
+
+#include "LinkedList.hpp"
+#include "UnrolledLinkedList.hpp"
+#include "StationManager.hpp"
+#include <algorithm>
+#include <cmath>
+#include <future>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+/**
+* Times a callable.
+* @param work The code to time.
+* @return: The elapsed wall time in milliseconds.
+*/
+template<class Work>
+double timeMs(Work work) {
+    auto start = std::chrono::steady_clock::now();
+    work();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+/**
+* Runs the positional workload against one list type.
+* @param label The name printed for this list type.
+* @param length The number of entries in the list.
+* @param lookups The number of random getEntry calls.
+* @param edits The number of random insert/remove pairs.
+*/
+template<class List>
+void benchList(const std::string& label, int length, int lookups, int edits) {
+    std::mt19937 rng(235);
+    List list;
+    long long checksum = 0;
+
+    double build_ms = timeMs([&]() {
+        for (int i = 0; i < length; i++)
+            list.insert(list.getLength(), i);
+    });
+
+    std::vector<int> positions(lookups);
+    for (int i = 0; i < lookups; i++)
+        positions[i] = std::uniform_int_distribution<int>(0, length - 1)(rng);
+
+    double lookup_ms = timeMs([&]() {
+        for (int i = 0; i < lookups; i++)
+            checksum += list.getEntry(positions[i]);
+    });
+
+    double edit_ms = timeMs([&]() {
+        for (int i = 0; i < edits; i++) {
+            int position = positions[i % lookups];
+            list.insert(position, i);
+            list.remove(position);
+        }
+    });
+
+    std::cout << label << " n=" << length
+              << "  build " << build_ms << " ms"
+              << "  getEntry x" << lookups << " " << lookup_ms << " ms"
+              << "  insert+remove x" << edits << " " << edit_ms << " ms"
+              << "  (checksum " << checksum << ")" << std::endl;
+}
+
+/**
+* Sends skewed demand at a kitchen whose stations can all make the same
+dish and prints the order latency percentiles. Half the orders are
+pinned to one station; idle workers have to steal them.
+* @param stations The number of stations.
+* @param orders The number of orders.
+*/
+void benchSkewedDispatch(int stations, int orders) {
+    StationManager manager;
+    for (int s = 0; s < stations; s++) {
+        std::string name = "Station" + std::to_string(s);
+        manager.addStation(new KitchenStation(name));
+        manager.replenishIngredientAtStation(name, Ingredient("Flour", orders, 1, 0.5));
+        manager.assignDishToStation(name, new Dish("Bread", {Ingredient("Flour", 0, 1, 0.5)}));
+    }
+
+    manager.startWorkers();
+    std::vector<std::future<bool>> results;
+    double total_ms = timeMs([&]() {
+        for (int i = 0; i < orders; i++) {
+            if (i % 2 == 0)
+                results.push_back(manager.prepareDishAtStationAsync("Station0", "Bread"));
+            else
+                results.push_back(manager.dispatchOrder("Bread"));
+        }
+        for (size_t i = 0; i < results.size(); i++)
+            results[i].get();
+    });
+    manager.stopWorkers();
+
+    OrderDispatcher::LatencyReport report = manager.orderLatencyReport();
+    std::cout << "Skewed dispatch stations=" << stations << " orders=" << report.orders
+              << "  total " << total_ms << " ms  stolen " << report.stolen
+              << "  p50 " << report.p50_us << " us  p90 " << report.p90_us
+              << " us  p99 " << report.p99_us << " us  max " << report.max_us << " us" << std::endl;
+}
+
+/**
+* Looks stations up by name with Zipf-distributed popularity under each
+access policy and prints how deep in the list the stations looked up
+sat on average, i.e. how many stations a walk from the front passes,
+next to what the lookups cost including the reordering.
+* @param stations The number of stations.
+* @param lookups The number of lookups per policy.
+* @param skew The Zipf exponent; station k is looked up in proportion
+to 1 / (k + 1)^skew.
+*/
+void benchAdaptiveLookup(int stations, int lookups, double skew) {
+    const char* labels[] = {"static       ", "move-to-front", "transpose    ", "frequency    "};
+    StationManager::AccessPolicy policies[] = {StationManager::STATIC_ORDER, StationManager::MOVE_TO_FRONT,
+                                               StationManager::TRANSPOSE, StationManager::FREQUENCY_COUNT};
+
+    std::mt19937 rng(235);
+    std::vector<double> weights(stations);
+    for (int k = 0; k < stations; k++)
+        weights[k] = 1.0 / std::pow(k + 1, skew);
+
+    //Popularity is unrelated to the order stations are added in
+    std::vector<std::string> names(stations);
+    for (int k = 0; k < stations; k++)
+        names[k] = "Station" + std::to_string(k);
+    std::vector<std::string> by_popularity = names;
+    std::shuffle(by_popularity.begin(), by_popularity.end(), rng);
+
+    std::discrete_distribution<int> zipf(weights.begin(), weights.end());
+    std::vector<int> picks(lookups);
+    for (int i = 0; i < lookups; i++)
+        picks[i] = zipf(rng);
+
+    for (int p = 0; p < 4; p++) {
+        StationManager manager;
+        for (int k = 0; k < stations; k++)
+            manager.addStation(new KitchenStation(names[k]));
+        manager.setAccessPolicy(policies[p]);
+
+        long long depth = 0;
+        double lookup_ms = 0;
+        for (int i = 0; i < lookups; i++) {
+            const std::string& name = by_popularity[picks[i]];
+            depth += manager.getStationPosition(name);
+            lookup_ms += timeMs([&]() { manager.findStation(name); });
+        }
+
+        std::cout << "Zipf lookups stations=" << stations << " s=" << skew << "  " << labels[p]
+                  << "  average depth " << (double)depth / lookups
+                  << "  findStation x" << lookups << " " << lookup_ms << " ms ("
+                  << lookup_ms * 1e6 / lookups << " ns each)" << std::endl;
+    }
+}
+
+/**
+* Plans restocking for a whole restaurant, with and without transfers
+between stations, and prints how long each plan took.
+* @param stations The number of stations.
+* @param dishes The number of dishes per station, each using 4 of the
+station's 80 ingredients.
+*/
+void benchReplenishmentPlan(int stations, int dishes) {
+    std::mt19937 rng(235);
+    StationManager manager;
+    std::vector<std::pair<std::string, int>> forecast;
+
+    for (int s = 0; s < stations; s++) {
+        std::string name = "Station" + std::to_string(s);
+        manager.addStation(new KitchenStation(name));
+
+        for (int d = 0; d < dishes; d++) {
+            std::vector<Ingredient> ingredients;
+            for (int i = 0; i < 4; i++)
+                ingredients.push_back(Ingredient("Item" + std::to_string((s + d * 4 + i) % 200), 0, 1 + i, 0.5));
+
+            //Dish names must be alphabetic
+            std::string dish = "Dish";
+            for (int n = s * dishes + d; n > 0; n /= 26)
+                dish += char('a' + n % 26);
+
+            manager.assignDishToStation(name, new Dish(dish, ingredients));
+            forecast.push_back({dish, 1 + rng() % 30});
+        }
+
+        for (int i = 0; i < 80; i++)
+            manager.replenishIngredientAtStation(name, Ingredient("Item" + std::to_string((s + i) % 200), 1 + rng() % 40, 1, 0.25 + rng() % 8 * 0.05));
+    }
+
+    for (bool transfers : {false, true}) {
+        StationManager::ReplenishmentPlan plan;
+        double plan_ms = timeMs([&]() { plan = manager.planReplenishment(forecast, transfers); });
+
+        std::cout << "Replenishment plan stations=" << stations << " dishes=" << stations * dishes
+                  << (transfers ? "  with transfers   " : "  without transfers")
+                  << "  purchases " << plan.purchases.size() << "  transfers " << plan.transfers.size()
+                  << "  cost " << plan.cost << "  " << plan_ms << " ms" << std::endl;
+    }
+}
+
+int main() {
+    for (int length : {1000, 5000, 20000}) {
+        benchList<LinkedList<int>>("LinkedList        ", length, 2000, 1000);
+        benchList<UnrolledLinkedList<int>>("UnrolledLinkedList", length, 2000, 1000);
+    }
+
+    benchSkewedDispatch(4, 20000);
+    benchSkewedDispatch(16, 20000);
+
+    benchAdaptiveLookup(1000, 100000, 1.0);
+    benchAdaptiveLookup(1000, 100000, 1.5);
+
+    benchReplenishmentPlan(500, 20);
+
+    return 0;
+}
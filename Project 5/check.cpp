@@ -0,0 +1,685 @@
+/**
+ * @brief Self-checks for the virtual bistro simulation. Build and run with
+ * `make check`; a failed check aborts with the assertion that did not hold.
+*/
+
+#include "LayoutFile.hpp"
+#include "LinkedList.hpp"
+#include "StationManager.hpp"
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+* Finds the quantity of an ingredient in a station's stock.
+* @param station The station.
+* @param ingredient_name The ingredient's name.
+* @return: The quantity; 0 if the ingredient is not in stock.
+*/
+int stockOf(const KitchenStation& station, const std::string& ingredient_name) {
+    std::vector<Ingredient> stock = station.getIngredientsStock();
+
+    for (size_t i = 0; i < stock.size(); i++) {
+        if (stock[i].name == ingredient_name)
+            return stock[i].quantity;
+    }
+
+    return 0;
+}
+
+/**
+* Copies the entries of a list.
+* @param list The list.
+* @return: Its entries from front to back.
+*/
+std::vector<int> entriesOf(const LinkedList<int>& list) {
+    std::vector<int> entries;
+
+    for (Node<int>* cur = list.getHeadNode(); cur != nullptr; cur = cur->getNext())
+        entries.push_back(cur->getItem());
+
+    return entries;
+}
+
+/**
+* Checks moving, extracting and splicing lists, and that the tail
+pointer is right afterwards: an append must land at the end.
+*/
+void checkListSplicing() {
+    LinkedList<int> list;
+    for (int i = 0; i < 5; i++)
+        list.insert(list.getLength(), i);
+
+    LinkedList<int> moved(std::move(list));
+    assert(list.isEmpty() && list.getHeadNode() == nullptr && list.getTailNode() == nullptr);
+    assert(entriesOf(moved) == std::vector<int>({0, 1, 2, 3, 4}));
+
+    LinkedList<int> assigned;
+    assigned.insert(0, 9);
+    assigned = std::move(moved);
+    assert(moved.isEmpty() && assigned.getLength() == 5);
+    assert(entriesOf(assigned) == std::vector<int>({0, 1, 2, 3, 4}));
+
+    //Moving the last node to the front, then the front node to the end
+    assert(assigned.extract(5) == nullptr);
+    assert(assigned.splice(0, assigned.extract(4)));
+    assert(assigned.splice(assigned.getLength(), assigned.extract(0)));
+    assert(assigned.splice(2, assigned.extract(4)));
+    assert(entriesOf(assigned) == std::vector<int>({0, 1, 4, 2, 3}));
+    assert(assigned.getLength() == 5 && assigned.getTailNode()->getItem() == 3);
+
+    LinkedList<int> back;
+    back.insert(0, 5);
+    back.insert(1, 6);
+    assert(assigned.splice(assigned.getLength(), back));
+    assert(back.isEmpty() && back.getTailNode() == nullptr);
+    assigned.insert(assigned.getLength(), 7);
+
+    LinkedList<int> middle;
+    middle.insert(0, 8);
+    assert(!assigned.splice(assigned.getLength() + 1, middle));
+    assert(assigned.splice(1, middle));
+    LinkedList<int> empty;
+    assert(assigned.splice(0, empty));
+
+    assert(entriesOf(assigned) == std::vector<int>({0, 8, 1, 4, 2, 3, 5, 6, 7}));
+    assert(assigned.getLength() == 9 && assigned.getTailNode()->getItem() == 7);
+    assert(assigned.remove(8) && assigned.getTailNode()->getItem() == 6);
+    assigned.insert(assigned.getLength(), 10);
+    assert(assigned.getEntry(8) == 10);
+}
+
+/**
+* Checks that a station merged into another brings its dishes and stock
+along and leaves nothing behind.
+*/
+void checkAbsorb() {
+    KitchenStation kept("Pantry");
+    KitchenStation merged("Cellar");
+    kept.assignDishToStation(new Dish("Toast", {Ingredient("Bread", 0, 1, 0.5)}));
+    merged.assignDishToStation(new Dish("Toast", {Ingredient("Bread", 0, 1, 0.5)}));
+    merged.assignDishToStation(new Dish("Cheese Plate", {Ingredient("Cheese", 0, 2, 1.5)}));
+    kept.replenishStationIngredients(Ingredient("Bread", 2, 1, 0.5));
+    merged.replenishStationIngredients(Ingredient("Bread", 3, 1, 0.5));
+    merged.replenishStationIngredients(Ingredient("Cheese", 4, 2, 1.5));
+
+    kept.absorb(std::move(merged));
+
+    assert(kept.getDishes().size() == 2);
+    assert(stockOf(kept, "Bread") == 5 && stockOf(kept, "Cheese") == 4);
+    assert(kept.servingsRemaining("Cheese Plate") == 2);
+    assert(merged.getIngredientsStock().empty());
+
+    //Toast was already assigned here, so the duplicate stays with the merged station
+    assert(merged.getDishes().size() == 1);
+}
+
+/**
+* Checks that a manager's stations and names line up: the list holds
+expected in order, and every name finds its own station at its own
+position.
+* @param manager The manager.
+* @param expected The station names from front to back.
+*/
+void assertStations(StationManager& manager, const std::vector<std::string>& expected) {
+    assert(manager.getLength() == (int)expected.size());
+
+    for (size_t i = 0; i < expected.size(); i++) {
+        KitchenStation* station = manager.getEntry(i);
+        assert(station->getName() == expected[i]);
+        assert(manager.peekStation(expected[i]) == station);
+        assert(manager.getStationPosition(expected[i]) == (int)i);
+    }
+
+    if (!expected.empty())
+        assert(manager.getTailNode()->getItem()->getName() == expected.back());
+}
+
+/**
+* Checks that the name index follows every change to the station list:
+merges, renames, moves to the front, removals and appends after them.
+*/
+void checkStationIndex() {
+    StationManager manager;
+    for (const char* name : {"A", "B", "C", "D", "E"})
+        assert(manager.addStation(new KitchenStation(name)));
+    KitchenStation duplicate("C");
+    assert(!manager.addStation(&duplicate));
+    assertStations(manager, {"A", "B", "C", "D", "E"});
+
+    assert(manager.mergeStations("B", "E"));
+    assert(manager.peekStation("E") == nullptr && !manager.mergeStations("B", "B"));
+    assertStations(manager, {"A", "B", "C", "D"});
+
+    KitchenStation* c = manager.findStation("C");
+    assert(c->setName("F"));
+    assert(manager.findStation("C") == nullptr && manager.findStation("F") == c);
+    assert(!manager.findStation("A")->setName("F"));
+    assertStations(manager, {"A", "B", "F", "D"});
+
+    assert(manager.moveStationToFront("D") && !manager.moveStationToFront("C"));
+    assertStations(manager, {"D", "A", "B", "F"});
+
+    assert(manager.removeStation("F") && !manager.removeStation("F"));
+    assertStations(manager, {"D", "A", "B"});
+
+    assert(manager.addStation(new KitchenStation("G")));
+    assert(manager.removeStation("D"));
+    assert(manager.addStation(new KitchenStation("H")));
+    assertStations(manager, {"A", "B", "G", "H"});
+}
+
+/**
+* Checks that a tryPrepare that falls short leaves the stock exactly as
+it was and reports every short ingredient, in both stock modes.
+*/
+void checkTryPrepareRollback() {
+    for (bool concurrent : {false, true}) {
+        KitchenStation station("Grill");
+        station.assignDishToStation(new Dish("Burger", {Ingredient("Bun", 0, 1, 0.5), Ingredient("Patty", 0, 2, 2.0), Ingredient("Cheese", 0, 1, 1.0)}));
+        station.replenishStationIngredients(Ingredient("Bun", 5, 1, 0.5));
+        station.replenishStationIngredients(Ingredient("Patty", 3, 2, 2.0));
+        station.setConcurrentStock(concurrent);
+
+        KitchenStation::PrepareResult first = station.tryPrepare("Burger");
+        assert(!first.prepared && first.dish_assigned);
+        assert(first.shortfalls.size() == 1 && first.shortfalls[0].ingredient == "Cheese");
+
+        //Patty would pass for one serving, so it must be given back
+        station.setConcurrentStock(false);
+        assert(stockOf(station, "Bun") == 5);
+        assert(stockOf(station, "Patty") == 3);
+        station.setConcurrentStock(concurrent);
+
+        station.replenishStationIngredients(Ingredient("Cheese", 1, 1, 1.0));
+        assert(station.tryPrepare("Burger").prepared);
+
+        //Now Patty (1 left) and Cheese (used up) both fall short
+        KitchenStation::PrepareResult second = station.tryPrepare("Burger");
+        assert(!second.prepared && second.shortfalls.size() == 2);
+
+        station.setConcurrentStock(false);
+        assert(stockOf(station, "Bun") == 4);
+        assert(stockOf(station, "Patty") == 1);
+        assert(!station.tryPrepare("Salad").dish_assigned);
+    }
+}
+
+/**
+* Checks that recovering from a snapshot and its log rebuilds the
+stations, also when the log ends in a record cut short by a crash.
+*/
+void checkLogRecovery() {
+    const std::string log_path = "check_events.log";
+    const std::string snapshot_path = "check_events.snap";
+    std::remove(log_path.c_str());
+    std::remove(snapshot_path.c_str());
+
+    std::vector<std::string> expected;
+    {
+        StationManager manager;
+        manager.addStation(new KitchenStation("Oven"));
+        manager.replenishIngredientAtStation("Oven", Ingredient("Dough", 10, 2, 0.25));
+        assert(manager.startEventLog(log_path, snapshot_path));
+
+        //Everything from here on is only in the log
+        manager.addStation(new KitchenStation("Wok"));
+        manager.assignDishToStation("Oven", new Dish("Pizza", {Ingredient("Dough", 0, 2, 0.25)}));
+        manager.assignDishToStation("Wok", new Dish("Noodles", {Ingredient("Dough", 0, 1, 0.25)}));
+        manager.replenishIngredientAtStation("Wok", Ingredient("Dough", 4, 1, 0.25));
+        assert(manager.prepareDishAtStation("Oven", "Pizza"));
+        assert(manager.prepareDishAtStation("Wok", "Noodles"));
+        manager.findStation("Wok")->setName("Fryer");
+        manager.stopEventLog();
+
+        for (Node<KitchenStation*>* cur = manager.getHeadNode(); cur != nullptr; cur = cur->getNext())
+            expected.push_back(cur->getItem()->getName() + ":" + std::to_string(stockOf(*cur->getItem(), "Dough")));
+    }
+
+    for (bool torn : {false, true}) {
+        if (torn) {
+            //Half of a record, as a crash in the middle of a write would leave it
+            std::FILE* file = std::fopen(log_path.c_str(), "ab");
+            assert(file != nullptr);
+            std::fputc(0x7f, file);
+            std::fputc(0x01, file);
+            std::fclose(file);
+        }
+
+        StationManager recovered;
+        assert(recovered.recover(snapshot_path, log_path));
+
+        std::vector<std::string> actual;
+        for (Node<KitchenStation*>* cur = recovered.getHeadNode(); cur != nullptr; cur = cur->getNext())
+            actual.push_back(cur->getItem()->getName() + ":" + std::to_string(stockOf(*cur->getItem(), "Dough")));
+
+        assert(actual == expected);
+        assert(recovered.findStation("Fryer")->servingsRemaining("Noodles") == 3);
+    }
+
+    std::remove(log_path.c_str());
+    std::remove(snapshot_path.c_str());
+}
+
+/**
+* Checks that reservations hold stock until they are committed, released
+or expire, and that expired ones give their stock back.
+*/
+void checkReservationExpiry() {
+    KitchenStation station("Bar");
+    station.assignDishToStation(new Dish("Mojito", {Ingredient("Mint", 0, 2, 0.1)}));
+    station.replenishStationIngredients(Ingredient("Mint", 10, 2, 0.1));
+
+    KitchenStation::ReservationHandle held = station.reserve("Mojito", 3);
+    KitchenStation::ReservationHandle brief = station.reserve("Mojito", 2, std::chrono::milliseconds(50));
+    assert(held != 0 && brief != 0);
+    assert(station.reserve("Mojito", 1) == 0);
+    assert(station.servingsRemaining("Mojito") == 0);
+
+    //Well past the ttl and the reservation tick
+    std::this_thread::sleep_for(std::chrono::milliseconds(400));
+    assert(station.expireReservations() == 1);
+    assert(station.servingsRemaining("Mojito") == 2);
+    assert(!station.commit(brief));
+
+    assert(station.commit(held));
+    assert(!station.release(held));
+    assert(stockOf(station, "Mint") == 4);
+    assert(station.servingsRemaining("Mojito") == 2);
+}
+
+/**
+* Reads the number of cached routing entries from a manager's metrics.
+* @param manager The manager.
+* @return: The bistro_route_cache_entries gauge.
+*/
+size_t cachedRoutes(const StationManager& manager) {
+    std::istringstream text(manager.metricsText());
+    std::string line;
+
+    while (std::getline(text, line)) {
+        if (line.rfind("bistro_route_cache_entries ", 0) == 0)
+            return std::stoul(line.substr(line.find(' ') + 1));
+    }
+
+    assert(false);
+    return 0;
+}
+
+/**
+* Checks that every change that can flip a station's answer reaches the
+routing cache before the next query, and that an answer computed while a
+station changed is returned but not cached.
+*/
+void checkRoutingCache() {
+    using Stations = std::vector<KitchenStation*>;
+    StationManager manager;
+    assert(manager.addStation(new KitchenStation("Grill")));
+    assert(manager.addStation(new KitchenStation("Oven")));
+    assert(manager.assignDishToStation("Grill", new Dish("Steak", {Ingredient("Beef", 0, 1, 4.0)})));
+
+    assert(!manager.canCompleteOrder("Steak") && manager.capableStations("Steak").empty());
+
+    //Replenishing makes the dish available
+    KitchenStation* grill = manager.findStation("Grill");
+    assert(manager.replenishIngredientAtStation("Grill", Ingredient("Beef", 1, 1, 4.0)));
+    assert(manager.capableStations("Steak") == Stations({grill}) && manager.canCompleteOrder("Steak"));
+
+    //Preparing the last serving takes it away again
+    assert(manager.prepareDishAtStation("Grill", "Steak"));
+    assert(manager.capableStations("Steak").empty() && !manager.canCompleteOrder("Steak"));
+
+    //Assigning the dish where its ingredient is already stocked
+    KitchenStation* oven = manager.findStation("Oven");
+    assert(manager.replenishIngredientAtStation("Oven", Ingredient("Beef", 2, 1, 4.0)));
+    assert(manager.capableStations("Steak").empty());
+    assert(manager.assignDishToStation("Oven", new Dish("Steak", {Ingredient("Beef", 0, 1, 4.0)})));
+    assert(manager.capableStations("Steak") == Stations({oven}) && manager.canCompleteOrder("Steak"));
+
+    //Merging moves the stock and the answer to the station that is kept
+    assert(manager.mergeStations("Grill", "Oven"));
+    assert(manager.capableStations("Steak") == Stations({grill}) && manager.canCompleteOrder("Steak"));
+
+    //Removing the only capable station
+    assert(manager.removeStation("Grill"));
+    assert(manager.capableStations("Steak").empty() && !manager.canCompleteOrder("Steak"));
+
+    //A reservation that expires during the scan changes the station under it
+    assert(manager.addStation(new KitchenStation("Wok")));
+    assert(manager.assignDishToStation("Wok", new Dish("Noodles", {Ingredient("Egg", 0, 1, 0.2)})));
+    assert(manager.replenishIngredientAtStation("Wok", Ingredient("Egg", 1, 1, 0.2)));
+    KitchenStation* wok = manager.findStation("Wok");
+    assert(wok->reserve("Noodles", 1, std::chrono::milliseconds(50)) != 0);
+    std::this_thread::sleep_for(std::chrono::milliseconds(400));
+
+    size_t cached = cachedRoutes(manager);
+    assert(manager.capableStations("Noodles") == Stations({wok}));
+    assert(cachedRoutes(manager) == cached);
+    assert(manager.capableStations("Noodles") == Stations({wok}));
+    assert(cachedRoutes(manager) == cached + 1);
+}
+
+/**
+* Checks that routing scans leave a station's failed-check metrics alone,
+so they count only the orders asked of the station itself.
+*/
+void checkRoutingUncounted() {
+    StationManager manager;
+    assert(manager.addStation(new KitchenStation("Fryer")));
+    assert(manager.addStation(new KitchenStation("Salad")));
+    for (const char* name : {"Fries", "Wedges", "Rings"})
+        assert(manager.assignDishToStation("Fryer", new Dish(name, {Ingredient("Potato", 0, 2, 0.3)})));
+    assert(manager.replenishIngredientAtStation("Fryer", Ingredient("Potato", 1, 2, 0.3)));
+
+    //A serial scan, then the parallel full, batched and early-exit scans
+    assert(manager.capableStations("Fries").empty());
+    manager.setParallelChecks(2);
+    assert(manager.capableStations("Wedges").empty());
+    assert(manager.canCompleteOrders(std::vector<std::string>({"Rings"})) == std::vector<bool>({false}));
+    assert(!manager.canCompleteOrder("Rings"));
+
+    KitchenStation* fryer = manager.findStation("Fryer");
+    KitchenStation* salad = manager.findStation("Salad");
+    assert(fryer->metrics().total(Metrics::ORDER_CHECKS_FAILED) == 0 && fryer->metrics().missing().empty());
+    assert(salad->metrics().total(Metrics::ORDER_CHECKS_FAILED) == 0);
+
+    //Asking the station itself is counted
+    assert(!fryer->canCompleteOrder("Fries"));
+    assert(fryer->metrics().total(Metrics::ORDER_CHECKS_FAILED) == 1 && fryer->metrics().missing().size() == 1);
+}
+
+/**
+* Checks that each access policy reorders the list as documented and
+counts accesses only while adaptive, including across policy switches,
+and that a long run under FREQUENCY_COUNT matches a plain sort.
+*/
+void checkAccessPolicies() {
+    StationManager manager;
+    for (const char* name : {"A", "B", "C", "D"})
+        assert(manager.addStation(new KitchenStation(name)));
+
+    manager.findStation("C");
+    manager.findStation("C");
+    assertStations(manager, {"A", "B", "C", "D"});
+    assert(manager.getAccessCount("C") == 0);
+
+    manager.setAccessPolicy(StationManager::MOVE_TO_FRONT);
+    for (const char* name : {"C", "D", "D"})
+        manager.findStation(name);
+    assertStations(manager, {"D", "C", "A", "B"});
+
+    manager.setAccessPolicy(StationManager::TRANSPOSE);
+    manager.findStation("B");
+    assertStations(manager, {"D", "C", "B", "A"});
+    for (int i = 0; i < 3; i++)
+        manager.findStation("B");
+    assertStations(manager, {"B", "D", "C", "A"});
+
+    //Sorting by the counts so far; equal counts keep their order
+    manager.setAccessPolicy(StationManager::FREQUENCY_COUNT);
+    assertStations(manager, {"B", "D", "C", "A"});
+    manager.findStation("A");
+    assertStations(manager, {"B", "D", "C", "A"});
+    manager.findStation("A");
+    assertStations(manager, {"B", "D", "A", "C"});
+    manager.findStation("C");
+    manager.findStation("C");
+    assertStations(manager, {"B", "C", "D", "A"});
+    manager.findStation("D");
+    manager.findStation("D");
+    assertStations(manager, {"B", "D", "C", "A"});
+    manager.findStation("D");
+    assertStations(manager, {"D", "B", "C", "A"});
+
+    //Counting goes on under another policy, and switching back re-sorts
+    manager.setAccessPolicy(StationManager::MOVE_TO_FRONT);
+    manager.findStation("A");
+    assertStations(manager, {"A", "D", "B", "C"});
+    manager.setAccessPolicy(StationManager::FREQUENCY_COUNT);
+    assertStations(manager, {"D", "B", "A", "C"});
+
+    std::vector<std::pair<std::string, long>> counts = {{"D", 5}, {"B", 4}, {"A", 3}, {"C", 3}};
+    for (size_t i = 0; i < counts.size(); i++)
+        assert(manager.getAccessCount(counts[i].first) == counts[i].second);
+
+    //A station found moves behind every station accessed at least as often
+    std::mt19937 random(7);
+    int next_name = 0;
+    for (int step = 0; step < 3000; step++) {
+        if (step % 100 == 50) {
+            std::string name = "N" + std::to_string(next_name++);
+            assert(manager.addStation(new KitchenStation(name)));
+            counts.emplace_back(name, 0);
+        }
+        else if (step % 100 == 99 && counts.size() > 2) {
+            size_t gone = random() % counts.size();
+            assert(manager.removeStation(counts[gone].first));
+            counts.erase(counts.begin() + gone);
+        }
+        else {
+            //Skewed towards the front, so runs of equal counts form and break up
+            size_t pick = std::min(random() % counts.size(), random() % counts.size());
+            std::pair<std::string, long> found = counts[pick];
+            found.second++;
+            counts.erase(counts.begin() + pick);
+
+            size_t position = 0;
+            while (position < counts.size() && counts[position].second >= found.second)
+                position++;
+            counts.insert(counts.begin() + position, found);
+
+            assert(manager.findStation(found.first)->getName() == found.first);
+        }
+
+        std::vector<std::string> expected;
+        for (size_t i = 0; i < counts.size(); i++) {
+            expected.push_back(counts[i].first);
+            assert(manager.getAccessCount(counts[i].first) == counts[i].second);
+        }
+        assertStations(manager, expected);
+    }
+}
+
+/**
+* Describes a kitchen in one string, so two kitchens can be compared.
+* @param manager The manager.
+* @return: Every station in list order with its dishes, in order, and its
+stock, sorted by ingredient.
+*/
+std::string describeKitchen(StationManager& manager) {
+    std::ostringstream text;
+    text.precision(17);
+
+    for (int i = 0; i < manager.getLength(); i++) {
+        KitchenStation* station = manager.getEntry(i);
+        text << "station " << station->getName() << "\n";
+
+        std::vector<const Dish*> dishes = station->getDishes();
+        for (size_t j = 0; j < dishes.size(); j++) {
+            text << " dish " << dishes[j]->getName() << " " << dishes[j]->getPrepTime() << " " << dishes[j]->getPrice() << " " << dishes[j]->getCuisineType();
+
+            std::vector<Ingredient> ingredients = dishes[j]->getIngredients();
+            for (size_t k = 0; k < ingredients.size(); k++)
+                text << " " << ingredients[k].name << " " << ingredients[k].quantity << " " << ingredients[k].required_quantity << " " << ingredients[k].price;
+            text << "\n";
+        }
+
+        std::vector<Ingredient> stock = station->getIngredientsStock();
+        std::sort(stock.begin(), stock.end(), [](const Ingredient& a, const Ingredient& b) {
+            return a.name < b.name;
+        });
+        for (size_t j = 0; j < stock.size(); j++)
+            text << " stock " << stock[j].name << " " << stock[j].quantity << " " << stock[j].required_quantity << " " << stock[j].price << "\n";
+    }
+
+    return text.str();
+}
+
+/**
+* Reads a whole file.
+* @param path The file.
+* @return: Its contents; empty if it cannot be read.
+*/
+std::string readFile(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    std::ostringstream contents;
+    contents << file.rdbuf();
+    return contents.str();
+}
+
+/**
+* Writes a whole file.
+* @param path The file.
+* @param contents What it holds.
+*/
+void writeFile(const std::string& path, const std::string& contents) {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file << contents;
+}
+
+/**
+* Checks that a kitchen survives a text and a binary save and load
+unchanged, that malformed text lines are rejected without adding
+anything, and that a name that cannot be written as a field stops a save.
+*/
+void checkLayoutFiles() {
+    const std::string stations_path = "check_layout_stations.csv";
+    const std::string stock_path = "check_layout_stock.csv";
+    const std::string binary_path = "check_layout.bin";
+
+    StationManager kitchen;
+    assert(kitchen.addStation(new KitchenStation("Pasta Bar")));
+    assert(kitchen.addStation(new KitchenStation("Taqueria")));
+    assert(kitchen.addStation(new KitchenStation("Empty")));
+    assert(kitchen.assignDishToStation("Pasta Bar", new Dish("Carbonara", {Ingredient("Spaghetti", 0, 2, 0.35), Ingredient("Egg", 0, 1, 0.1)}, 12, 13.5, Dish::ITALIAN)));
+    assert(kitchen.assignDishToStation("Pasta Bar", new Dish("Pesto", {Ingredient("Spaghetti", 0, 2, 0.35)}, 8, 0.1 + 0.2, Dish::OTHER)));
+    assert(kitchen.assignDishToStation("Taqueria", new Dish("Tacos", {Ingredient("Tortilla", 0, 3, 0.25)}, 5, 9.99, Dish::MEXICAN)));
+    assert(kitchen.replenishIngredientAtStation("Pasta Bar", Ingredient("Spaghetti", 7, 2, 0.35)));
+    assert(kitchen.replenishIngredientAtStation("Pasta Bar", Ingredient("Egg", 4, 1, 0.1)));
+    assert(kitchen.replenishIngredientAtStation("Taqueria", Ingredient("Tortilla", 30, 3, 0.25)));
+    assert(kitchen.replenishIngredientAtStation("Taqueria", Ingredient("Lime", 2, 1, 1.0 / 3)));
+    std::string expected = describeKitchen(kitchen);
+
+    //Text: loading what was saved gives the same kitchen, which saves the same files
+    assert(kitchen.saveToFile(stations_path, stock_path));
+    std::string stations_text = readFile(stations_path);
+    std::string stock_text = readFile(stock_path);
+
+    StationManager from_text;
+    assert(from_text.loadFromFile(stations_path, stock_path));
+    assert(describeKitchen(from_text) == expected);
+    assert(!from_text.loadFromFile(stations_path, stock_path));
+    assert(from_text.saveToFile(stations_path, stock_path));
+    assert(readFile(stations_path) == stations_text && readFile(stock_path) == stock_text);
+
+    //Binary: the same kitchen as the text files give
+    assert(from_text.saveToBinaryFile(binary_path));
+    StationManager from_binary;
+    assert(from_binary.loadFromBinaryFile(binary_path));
+    assert(describeKitchen(from_binary) == describeKitchen(from_text));
+
+    //Malformed lines, each added to the good files in turn
+    std::vector<std::string> bad_stations = {
+        "Grill,Steak,ten,30,AMERICAN,Beef,0,1,8",
+        "Grill,Steak,10,30,KLINGON,Beef,0,1,8",
+        "Grill,Steak,10,30,AMERICAN,Beef,0,1",
+        "Grill,Steak,10,30",
+        ",Steak,10,30,AMERICAN,Beef,0,1,8"
+    };
+    std::vector<std::string> bad_stock = {
+        "Taqueria,Lime,2.5,1,0.3",
+        "Taqueria,Lime,2,1",
+        "Taqueria,Lime,-2,1,0.3",
+        "Grill,Lime,2,1,0.3"
+    };
+
+    for (size_t i = 0; i < bad_stations.size() + bad_stock.size(); i++) {
+        if (i < bad_stations.size())
+            writeFile(stations_path, stations_text + bad_stations[i] + "\n");
+        else
+            writeFile(stock_path, stock_text + bad_stock[i - bad_stations.size()] + "\n");
+
+        StationManager rejected;
+        assert(!rejected.loadFromFile(stations_path, stock_path));
+        assert(rejected.getLength() == 0);
+
+        writeFile(stations_path, stations_text);
+        writeFile(stock_path, stock_text);
+    }
+
+    //A comma in a name would split its field when read back
+    assert(kitchen.findStation("Empty")->setName("Empty, North"));
+    assert(!LayoutFile::isWritable("Empty, North"));
+    assert(!kitchen.saveToFile(stations_path, stock_path));
+
+    std::remove(stations_path.c_str());
+    std::remove(stock_path.c_str());
+    std::remove(binary_path.c_str());
+}
+
+/**
+* Checks the replenishment planner: leftovers are moved before anything
+is bought, purchases use the lowest known price, and a dish's forecast is
+planned at the first station that has it.
+*/
+void checkReplenishmentPlan() {
+    StationManager manager;
+    manager.addStation(new KitchenStation("Soup"));
+    manager.addStation(new KitchenStation("Tea"));
+    manager.assignDishToStation("Soup", new Dish("Broth", {Ingredient("Bones", 0, 2, 1.0)}));
+    manager.assignDishToStation("Tea", new Dish("Chai", {Ingredient("Leaves", 0, 1, 0.2)}));
+    manager.assignDishToStation("Tea", new Dish("Broth", {Ingredient("Bones", 0, 2, 1.0)}));
+    manager.replenishIngredientAtStation("Soup", Ingredient("Bones", 3, 2, 1.0));
+    manager.replenishIngredientAtStation("Tea", Ingredient("Bones", 10, 2, 0.5));
+    manager.replenishIngredientAtStation("Tea", Ingredient("Leaves", 1, 1, 0.2));
+
+    //Soup needs 8 Bones and has 3; Tea needs 2 Leaves and has 1
+    std::vector<std::pair<std::string, int>> forecast = {{"Broth", 4}, {"Chai", 2}, {"Unknown", 9}};
+
+    StationManager::ReplenishmentPlan bought = manager.planReplenishment(forecast, false);
+    assert(bought.transfers.empty() && bought.purchases.size() == 2);
+    for (size_t i = 0; i < bought.purchases.size(); i++) {
+        const StationManager::Purchase& purchase = bought.purchases[i];
+        if (purchase.ingredient.name == "Bones")
+            assert(purchase.station == "Soup" && purchase.ingredient.quantity == 5 && purchase.ingredient.price == 0.5);
+        else
+            assert(purchase.station == "Tea" && purchase.ingredient.name == "Leaves" && purchase.ingredient.quantity == 1);
+    }
+    assert(bought.cost == 5 * 0.5 + 1 * 0.2);
+
+    //Tea has 10 Bones to spare, since the Broth forecast went to Soup
+    StationManager::ReplenishmentPlan moved = manager.planReplenishment(forecast, true);
+    assert(moved.transfers.size() == 1 && moved.purchases.size() == 1);
+    assert(moved.transfers[0].from == "Tea" && moved.transfers[0].to == "Soup");
+    assert(moved.transfers[0].ingredient == "Bones" && moved.transfers[0].quantity == 5);
+    assert(moved.purchases[0].ingredient.name == "Leaves");
+    assert(moved.cost == 1 * 0.2);
+
+    //Planning changes nothing
+    assert(stockOf(*manager.findStation("Soup"), "Bones") == 3);
+}
+
+int main() {
+    checkListSplicing();
+    checkAbsorb();
+    checkStationIndex();
+    checkTryPrepareRollback();
+    checkLogRecovery();
+    checkReservationExpiry();
+    checkRoutingCache();
+    checkRoutingUncounted();
+    checkAccessPolicies();
+    checkLayoutFiles();
+    checkReplenishmentPlan();
+
+    std::cout << "All checks passed" << std::endl;
+    return 0;
+}
@@ -0,0 +1,38 @@
+/**
+ * @brief Rebuilds the stations of a virtual bistro simulation from a
+ * snapshot and its event log, then prints them. Build with `make replay`
+ * and run ./replay <snapshot> <log>.
+*/
+
+#include "StationManager.hpp"
+#include <iostream>
+#include <string>
+#include <vector>
+
+int main(int argc, char* argv[]) {
+    if (argc != 3) {
+        std::cerr << "usage: " << argv[0] << " <snapshot> <log>" << std::endl;
+        return 1;
+    }
+
+    StationManager manager;
+    if (!manager.recover(argv[1], argv[2])) {
+        std::cerr << "could not read snapshot " << argv[1] << std::endl;
+        return 1;
+    }
+
+    for (Node<KitchenStation*>* cur = manager.getHeadNode(); cur != nullptr; cur = cur->getNext()) {
+        KitchenStation* station = cur->getItem();
+        std::cout << "Station " << station->getName() << std::endl;
+
+        std::vector<std::pair<std::string, int>> board = station->getServingsBoard();
+        for (size_t i = 0; i < board.size(); i++)
+            std::cout << "  dish " << board[i].first << ": " << board[i].second << " servings left" << std::endl;
+
+        std::vector<Ingredient> stock = station->getIngredientsStock();
+        for (size_t i = 0; i < stock.size(); i++)
+            std::cout << "  stock " << stock[i].name << ": " << stock[i].quantity << std::endl;
+    }
+
+    return 0;
+}